@@ -36,6 +36,30 @@ const getOrCreateArchive = (archivePath: string) => {
   return newArchive;
 };
 
+// Kinds of entries reported by |archive.statBatch|, which returns a
+// [kind, size, offset] triple per path.
+const enum AsarStatKind {
+  Missing = 0,
+  File = 1,
+  Directory = 2,
+  Link = 3
+}
+const kStatBatchFields = 3;
+
+// Results of internalModuleStat lookups by archive. Archives never change, so
+// misses are cached as well. Any path can miss, so a cache that grows past
+// the limit is dropped and starts over.
+const moduleStatCaches = new WeakMap<NodeJS.AsarArchive, Map<string, number>>();
+const kMaxModuleStatCacheSize = 4096;
+
+// Paths module resolution probes after a path without one of its extensions.
+const moduleExtensions = ['.js', '.json', '.node'];
+const moduleCandidateSuffixes = [
+  ...moduleExtensions,
+  path.join(path.sep, 'package.json'),
+  ...moduleExtensions.map(ext => path.join(path.sep, `index${ext}`))
+];
+
 const asarRe = /\.asar/i;
 
 // Separate asar package's path from full path.
@@ -530,6 +554,18 @@ export const wrapFsWithAsar = (fs: Record<string, any>) => {
         return fs.readFile(realPath, options, callback);
       }
 
+      if (info.compressed) {
+        logASARAccess(asarPath, filePath, info.offset);
+        archive.readAsync(filePath).then(buffer => {
+          if (!buffer) {
+            callback(createError(AsarError.INVALID_ARCHIVE, { asarPath }));
+            return;
+          }
+          callback(null, encoding ? buffer.toString(encoding) : buffer);
+        }, callback);
+        return;
+      }
+
       const buffer = Buffer.alloc(info.size);
       const fd = archive.getFd();
       if (!(fd >= 0)) {
@@ -594,6 +630,13 @@ export const wrapFsWithAsar = (fs: Record<string, any>) => {
     }
 
     const { encoding } = options;
+    if (info.compressed) {
+      const buffer = archive.read(filePath);
+      if (!buffer) throw createError(AsarError.INVALID_ARCHIVE, { asarPath });
+      logASARAccess(asarPath, filePath, info.offset);
+      return (encoding) ? buffer.toString(encoding) : buffer;
+    }
+
     const buffer = Buffer.alloc(info.size);
     const fd = archive.getFd();
     if (!(fd >= 0)) throw createError(AsarError.NOT_FOUND, { asarPath, filePath });
@@ -603,6 +646,14 @@ export const wrapFsWithAsar = (fs: Record<string, any>) => {
     return (encoding) ? buffer.toString(encoding) : buffer;
   };
 
+  const direntTypeFromStatKind = (kind: AsarStatKind) => {
+    switch (kind) {
+      case AsarStatKind.Directory: return fs.constants.UV_DIRENT_DIR;
+      case AsarStatKind.Link: return fs.constants.UV_DIRENT_LINK;
+      default: return fs.constants.UV_DIRENT_FILE;
+    }
+  };
+
   const { readdir } = fs;
   fs.readdir = function (pathArgument: string, options: { encoding?: string | null; withFileTypes?: boolean } = {}, callback?: Function) {
     const pathInfo = splitPath(pathArgument);
@@ -629,21 +680,16 @@ export const wrapFsWithAsar = (fs: Record<string, any>) => {
 
     if (options.withFileTypes) {
       const dirents = [];
-      for (const file of files) {
-        const childPath = path.join(filePath, file);
-        const stats = archive.stat(childPath);
-        if (!stats) {
-          const error = createError(AsarError.NOT_FOUND, { asarPath, filePath: childPath });
+      const childPaths = files.map(file => path.join(filePath, file));
+      const results = archive.statBatch(childPaths);
+      for (let i = 0; i < files.length; i++) {
+        const kind = results[i * kStatBatchFields];
+        if (kind === AsarStatKind.Missing) {
+          const error = createError(AsarError.NOT_FOUND, { asarPath, filePath: childPaths[i] });
           nextTick(callback!, [error]);
           return;
         }
-        if (stats.isFile) {
-          dirents.push(new fs.Dirent(file, fs.constants.UV_DIRENT_FILE));
-        } else if (stats.isDirectory) {
-          dirents.push(new fs.Dirent(file, fs.constants.UV_DIRENT_DIR));
-        } else if (stats.isLink) {
-          dirents.push(new fs.Dirent(file, fs.constants.UV_DIRENT_LINK));
-        }
+        dirents.push(new fs.Dirent(files[i], direntTypeFromStatKind(kind)));
       }
       nextTick(callback!, [null, dirents]);
       return;
@@ -674,19 +720,14 @@ export const wrapFsWithAsar = (fs: Record<string, any>) => {
 
     if (options && (options as ReaddirSyncOptions).withFileTypes) {
       const dirents = [];
-      for (const file of files) {
-        const childPath = path.join(filePath, file);
-        const stats = archive.stat(childPath);
-        if (!stats) {
-          throw createError(AsarError.NOT_FOUND, { asarPath, filePath: childPath });
-        }
-        if (stats.isFile) {
-          dirents.push(new fs.Dirent(file, fs.constants.UV_DIRENT_FILE));
-        } else if (stats.isDirectory) {
-          dirents.push(new fs.Dirent(file, fs.constants.UV_DIRENT_DIR));
-        } else if (stats.isLink) {
-          dirents.push(new fs.Dirent(file, fs.constants.UV_DIRENT_LINK));
+      const childPaths = files.map(file => path.join(filePath, file));
+      const results = archive.statBatch(childPaths);
+      for (let i = 0; i < files.length; i++) {
+        const kind = results[i * kStatBatchFields];
+        if (kind === AsarStatKind.Missing) {
+          throw createError(AsarError.NOT_FOUND, { asarPath, filePath: childPaths[i] });
         }
+        dirents.push(new fs.Dirent(files[i], direntTypeFromStatKind(kind)));
       }
       return dirents;
     }
@@ -712,12 +753,19 @@ export const wrapFsWithAsar = (fs: Record<string, any>) => {
       return [str, str.length > 0];
     }
 
-    const buffer = Buffer.alloc(info.size);
-    const fd = archive.getFd();
-    if (!(fd >= 0)) return [];
+    let buffer: Buffer;
+    if (info.compressed) {
+      const contents = archive.read(filePath);
+      if (!contents) return [];
+      buffer = contents;
+    } else {
+      buffer = Buffer.alloc(info.size);
+      const fd = archive.getFd();
+      if (!(fd >= 0)) return [];
+      fs.readSync(fd, buffer, 0, info.size, info.offset);
+    }
 
     logASARAccess(asarPath, filePath, info.offset);
-    fs.readSync(fd, buffer, 0, info.size, info.offset);
     const str = buffer.toString('utf8');
     return [str, str.length > 0];
   };
@@ -732,11 +780,35 @@ export const wrapFsWithAsar = (fs: Record<string, any>) => {
     const archive = getOrCreateArchive(asarPath);
     if (!archive) return -34;
 
-    // -ENOENT
-    const stats = archive.stat(filePath);
-    if (!stats) return -34;
+    let cache = moduleStatCaches.get(archive);
+    if (!cache) {
+      cache = new Map();
+      moduleStatCaches.set(archive, cache);
+    }
 
-    return (stats.isDirectory) ? 1 : 0;
+    const cached = cache.get(filePath);
+    if (cached !== undefined) return cached;
+
+    const statPaths = (paths: string[]) => {
+      if (cache!.size + paths.length > kMaxModuleStatCacheSize) cache!.clear();
+      const results = archive.statBatch(paths);
+      for (let i = 0; i < paths.length; i++) {
+        const kind = results[i * kStatBatchFields];
+        // -ENOENT
+        const rc = kind === AsarStatKind.Missing ? -34 : (kind === AsarStatKind.Directory ? 1 : 0);
+        cache!.set(paths[i], rc);
+      }
+    };
+
+    statPaths([filePath]);
+    const rc = cache.get(filePath)!;
+
+    // Module resolution goes on to try the candidates of a path that is not a
+    // file, so stat them all at once to answer those from the cache.
+    if (rc !== 0 && !moduleExtensions.includes(path.extname(filePath))) {
+      statPaths(moduleCandidateSuffixes.map(suffix => filePath + suffix));
+    }
+    return rc;
   };
 
   // Calling mkdir for directory inside asar archive should throw ENOTDIR
@@ -532,6 +532,17 @@ const addSenderFrameToEvent = (event: Electron.IpcMainEvent | Electron.IpcMainIn
   });
 };
 
+const isBatchedMessage = (message: unknown): message is [string, any[]] => {
+  return Array.isArray(message) && message.length === 2 &&
+    typeof message[0] === 'string' && Array.isArray(message[1]);
+};
+
+const emitIpcMessage = (contents: Electron.WebContents, event: Electron.IpcMainEvent, channel: string, args: any[]) => {
+  addReplyToEvent(event);
+  contents.emit('ipc-message', event, channel, ...args);
+  ipcMain.emit(channel, event, ...args);
+};
+
 const addReturnValueToEvent = (event: Electron.IpcMainEvent) => {
   Object.defineProperty(event, 'returnValue', {
     set: (value) => event.sendReply(value),
@@ -561,12 +572,21 @@ WebContents.prototype._init = function () {
   // Dispatch IPC messages to the ipc module.
   this.on('-ipc-message' as any, function (this: Electron.WebContents, event: Electron.IpcMainEvent, internal: boolean, channel: string, args: any[]) {
     addSenderFrameToEvent(event);
-    if (internal) {
+    if (internal && channel === IPC_MESSAGES.BROWSER_BATCHED_MESSAGES) {
+      // Every message of the batch gets its own event, which shares the
+      // sender details of the batch. The batch comes from the renderer, so
+      // anything that is not a [channel, args] pair is dropped.
+      const [messages] = args;
+      if (!Array.isArray(messages)) return;
+      for (const message of messages) {
+        if (!isBatchedMessage(message)) continue;
+        const [batchedChannel, batchedArgs] = message;
+        emitIpcMessage(this, Object.create(event), batchedChannel, batchedArgs);
+      }
+    } else if (internal) {
       ipcMainInternal.emit(channel, event, ...args);
     } else {
-      addReplyToEvent(event);
-      this.emit('ipc-message', event, channel, ...args);
-      ipcMain.emit(channel, event, ...args);
+      emitIpcMessage(this, event, channel, args);
     }
   });
 
@@ -783,3 +803,10 @@ export function getFocusedWebContents () {
 export function getAllWebContents () {
   return binding.getAllWebContents();
 }
+
+export function broadcast (channel: string, value: any, options?: Electron.BroadcastOptions) {
+  if (typeof channel !== 'string') {
+    throw new Error('Missing required channel argument');
+  }
+  return binding.broadcast(channel, value, options);
+}
@@ -18,11 +18,17 @@ WebFrameMain.prototype._sendInternal = function (channel, ...args) {
   return this._send(true /* internal */, channel, args);
 };
 
-WebFrameMain.prototype.postMessage = function (...args) {
-  if (Array.isArray(args[2])) {
-    args[2] = args[2].map(o => o instanceof MessagePortMain ? o._internalPort : o);
-  }
-  this._postMessage(...args);
+const unwrapPorts = (transfer?: any[]) => {
+  if (transfer === undefined) return [];
+  return Array.isArray(transfer) ? transfer.map(o => o instanceof MessagePortMain ? o._internalPort : o) : transfer;
+};
+
+WebFrameMain.prototype.postMessage = function (channel, message, transfer) {
+  this._postMessage(false /* internal */, channel, message, unwrapPorts(transfer));
+};
+
+WebFrameMain.prototype._postMessageInternal = function (channel, message, transfer) {
+  this._postMessage(true /* internal */, channel, message, unwrapPorts(transfer));
 };
 
 export default {
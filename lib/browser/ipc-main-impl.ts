@@ -1,8 +1,113 @@
 import { EventEmitter } from 'events';
+import * as path from 'path';
+import { Worker } from 'worker_threads';
 import { IpcMainInvokeEvent } from 'electron/main';
 
+const { setSharedValue, deleteSharedValue } = process._linkedBinding('electron_browser_shared_values');
+
+// Runs in every worker thread of a handleInWorker() handler: loads the
+// handler module and answers the calls posted to it. Errors keep their stack,
+// and any thrown value, even a falsy one, rejects the call.
+const workerSource = `
+const { parentPort, workerData } = require('worker_threads');
+const exported = require(workerData.filename);
+const handler = typeof exported === 'function' ? exported : exported.default;
+parentPort.on('message', async ({ id, args }) => {
+  try {
+    parentPort.postMessage({ id, result: await handler(...args) });
+  } catch (error) {
+    const isError = error instanceof Error;
+    const thrown = isError ? { name: error.name, message: error.message, stack: error.stack } : error;
+    try {
+      parentPort.postMessage({ id, failed: true, isError, error: thrown });
+    } catch {
+      parentPort.postMessage({ id, failed: true, isError: false, error: String(error) });
+    }
+  }
+});
+parentPort.postMessage({ ready: true });
+`;
+
+type PendingCall = { worker: Worker, resolve: (result: any) => void, reject: (error: any) => void };
+
+class WorkerPool {
+  private workers: Worker[] = [];
+  private pending = new Map<number, PendingCall>();
+  private nextId = 0;
+  private nextWorker = 0;
+  private terminated = false;
+
+  constructor (private filename: string, threads: number) {
+    for (let i = 0; i < threads; i++) {
+      this.spawn();
+    }
+  }
+
+  call (args: any[]) {
+    if (this.workers.length === 0) {
+      return Promise.reject(new Error(`No workers left to handle calls for ${this.filename}`));
+    }
+    this.nextWorker %= this.workers.length;
+    const worker = this.workers[this.nextWorker];
+    this.nextWorker = (this.nextWorker + 1) % this.workers.length;
+    const id = this.nextId++;
+    return new Promise((resolve, reject) => {
+      this.pending.set(id, { worker, resolve, reject });
+      worker.postMessage({ id, args });
+    });
+  }
+
+  terminate () {
+    this.terminated = true;
+    for (const worker of this.workers) {
+      worker.terminate();
+    }
+  }
+
+  private spawn () {
+    const worker = new Worker(workerSource, { eval: true, workerData: { filename: this.filename } });
+    let ready = false;
+    // Idle handlers should not keep the app alive.
+    worker.unref();
+    worker.on('message', ({ id, ready: isReady, result, failed, isError, error }) => {
+      if (isReady) {
+        ready = true;
+        return;
+      }
+      const call = this.pending.get(id);
+      if (!call) return;
+      this.pending.delete(id);
+      if (failed) {
+        call.reject(isError ? Object.assign(new Error(error.message), error) : error);
+      } else {
+        call.resolve(result);
+      }
+    });
+    worker.on('error', (error) => this.rejectPending(worker, error));
+    worker.on('exit', (code) => {
+      this.rejectPending(worker, new Error(`Worker exited with code ${code}`));
+      this.workers = this.workers.filter(w => w !== worker);
+      // Replace workers that die while serving calls, but not ones whose
+      // handler module failed to load, which would only fail again.
+      if (ready && !this.terminated) {
+        this.spawn();
+      }
+    });
+    this.workers.push(worker);
+  }
+
+  private rejectPending (worker: Worker, error: any) {
+    for (const [id, call] of this.pending) {
+      if (call.worker !== worker) continue;
+      this.pending.delete(id);
+      call.reject(error);
+    }
+  }
+}
+
 export class IpcMainImpl extends EventEmitter {
   private _invokeHandlers: Map<string, (e: IpcMainInvokeEvent, ...args: any[]) => void> = new Map();
+  private _workerPools: Map<string, WorkerPool> = new Map();
 
   handle: Electron.IpcMain['handle'] = (method, fn) => {
     if (this._invokeHandlers.has(method)) {
@@ -27,7 +132,44 @@ export class IpcMainImpl extends EventEmitter {
     });
   }
 
+  handleInWorker: Electron.IpcMain['handleInWorker'] = (method, filename, options = {}) => {
+    if (typeof filename !== 'string') {
+      throw new Error(`Expected filename to be a string, but found type '${typeof filename}'`);
+    }
+    // Workers would resolve a relative path against the current working
+    // directory, rather than the module registering the handler.
+    if (!path.isAbsolute(filename)) {
+      throw new Error(`Expected filename to be an absolute path, but found '${filename}'`);
+    }
+    const { threads = 1 } = options;
+    if (!Number.isInteger(threads) || threads < 1) {
+      throw new Error('Expected threads to be a positive integer');
+    }
+    if (this._invokeHandlers.has(method)) {
+      throw new Error(`Attempted to register a second handler for '${method}'`);
+    }
+    const pool = new WorkerPool(filename, threads);
+    this.handle(method, (e, ...args) => pool.call(args));
+    this._workerPools.set(method, pool);
+  }
+
+  setSharedValue (key: string, value: any, options: { session?: Electron.Session } = {}) {
+    if (typeof key !== 'string') {
+      throw new Error('Missing required key argument');
+    }
+    setSharedValue(key, value, options.session);
+  }
+
+  deleteSharedValue (key: string) {
+    deleteSharedValue(key);
+  }
+
   removeHandler (method: string) {
     this._invokeHandlers.delete(method);
+    const pool = this._workerPools.get(method);
+    if (pool) {
+      this._workerPools.delete(method);
+      pool.terminate();
+    }
   }
 }
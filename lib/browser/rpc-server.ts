@@ -1,4 +1,4 @@
-import { app } from 'electron/main';
+import { app, webContents, MessageChannelMain } from 'electron/main';
 import type { WebContents } from 'electron/main';
 import { clipboard, nativeImage } from 'electron/common';
 import * as fs from 'fs';
@@ -35,6 +35,68 @@ ipcMainInternal.on(IPC_MESSAGES.BROWSER_WINDOW_CLOSE, function (event) {
   event.returnValue = null;
 });
 
+// Connection requests nobody answered within this time are refused.
+const CONNECT_TO_TIMEOUT = 30 * 1000;
+
+// Implements ipcRenderer.connectTo(). Once both ends of the channel are in
+// renderers, their messages no longer pass through the main process.
+ipcMainInternal.on(IPC_MESSAGES.BROWSER_CONNECT_TO, function (event, requestId: number, webContentsId: number, channel: string) {
+  const frame = event.senderFrame;
+  if (!frame) return;
+  const respond = (error: string | null, transfer: Electron.MessagePortMain[] = []) => {
+    frame._postMessageInternal(`${IPC_MESSAGES.BROWSER_CONNECT_TO}_RESPONSE_${requestId}`, error, transfer);
+  };
+
+  const target = webContents.fromId(webContentsId);
+  if (!target || target.isDestroyed()) {
+    return respond(`No WebContents with id ${webContentsId}`);
+  }
+
+  // Connections are refused unless the app explicitly allows them.
+  const eventName = 'ipc-renderer-connect-to';
+  if (app.listenerCount(eventName) + event.sender.listenerCount(eventName) === 0) {
+    return respond(`Connection to WebContents ${webContentsId} was refused`);
+  }
+
+  const senderId = event.sender.id;
+  const sender = event.sender;
+  let settled = false;
+  // The request must settle even if no listener ever answers it, or if
+  // either side goes away while it waits for an answer.
+  const settle = () => {
+    if (settled) return false;
+    settled = true;
+    clearTimeout(timeout);
+    target.removeListener('destroyed', onTargetDestroyed);
+    sender.removeListener('destroyed', onSenderDestroyed);
+    return true;
+  };
+  const onTargetDestroyed = () => {
+    if (settle()) respond(`No WebContents with id ${webContentsId}`);
+  };
+  const onSenderDestroyed = () => { settle(); };
+  const timeout = setTimeout(() => {
+    if (settle()) respond(`Connection to WebContents ${webContentsId} was refused`);
+  }, CONNECT_TO_TIMEOUT);
+  target.once('destroyed', onTargetDestroyed);
+  sender.once('destroyed', onSenderDestroyed);
+
+  const callback = (allow: boolean) => {
+    if (!settle()) return;
+    if (!allow) {
+      return respond(`Connection to WebContents ${webContentsId} was refused`);
+    }
+    if (target.isDestroyed()) {
+      return respond(`No WebContents with id ${webContentsId}`);
+    }
+    const { port1, port2 } = new MessageChannelMain();
+    target.mainFrame._postMessageInternal(IPC_MESSAGES.RENDERER_CONNECT_FROM, { senderId, channel }, [port2]);
+    respond(null, [port1]);
+  };
+
+  emitCustomEvent(event.sender, eventName, target, channel, callback);
+});
+
 ipcMainInternal.handle(IPC_MESSAGES.BROWSER_GET_LAST_WEB_PREFERENCES, function (event) {
   return event.sender.getLastWebPreferences();
 });
@@ -1,5 +1,7 @@
 export const enum IPC_MESSAGES {
+  BROWSER_BATCHED_MESSAGES = 'BROWSER_BATCHED_MESSAGES',
   BROWSER_CLIPBOARD_SYNC = 'BROWSER_CLIPBOARD_SYNC',
+  BROWSER_CONNECT_TO = 'BROWSER_CONNECT_TO',
   BROWSER_GET_LAST_WEB_PREFERENCES = 'BROWSER_GET_LAST_WEB_PREFERENCES',
   BROWSER_PRELOAD_ERROR = 'BROWSER_PRELOAD_ERROR',
   BROWSER_SANDBOX_LOAD = 'BROWSER_SANDBOX_LOAD',
@@ -27,6 +29,7 @@ export const enum IPC_MESSAGES {
   GUEST_WINDOW_MANAGER_WEB_CONTENTS_METHOD = 'GUEST_WINDOW_MANAGER_WEB_CONTENTS_METHOD',
   GUEST_WINDOW_POSTMESSAGE = 'GUEST_WINDOW_POSTMESSAGE',
 
+  RENDERER_CONNECT_FROM = 'RENDERER_CONNECT_FROM',
   RENDERER_WEB_FRAME_METHOD = 'RENDERER_WEB_FRAME_METHOD',
 
   INSPECTOR_CONFIRM = 'INSPECTOR_CONFIRM',
@@ -8,9 +8,13 @@ const checkContextIsolationEnabled = () => {
 };
 
 const contextBridge: Electron.ContextBridge = {
-  exposeInMainWorld: (key: string, api: any) => {
+  exposeInMainWorld: (key: string, api: any, options?: Electron.ExposeInMainWorldOptions) => {
     checkContextIsolationEnabled();
-    return binding.exposeAPIInMainWorld(key, api);
+    return binding.exposeAPIInMainWorld(key, api, options);
+  },
+  transfer: (value: any) => {
+    checkContextIsolationEnabled();
+    return binding.markForTransfer(value);
   }
 };
 
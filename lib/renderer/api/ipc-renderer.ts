@@ -1,27 +1,69 @@
 import { EventEmitter } from 'events';
+import { IPC_MESSAGES } from '@electron/internal/common/ipc-messages';
+import { ipcRendererInternal } from '@electron/internal/renderer/ipc-renderer-internal';
 
 const { ipc } = process._linkedBinding('electron_renderer_ipc');
 
 const internal = false;
 
+// Messages passed to sendBatched() since the last microtask checkpoint.
+let batchedMessages: [string, any[]][] = [];
+
+// Sends the pending batched messages. Called before any other message leaves
+// this renderer, so that batching never reorders messages.
+const flushBatchedMessages = () => {
+  if (batchedMessages.length === 0) return;
+  const messages = batchedMessages;
+  batchedMessages = [];
+  try {
+    ipc.send(true, IPC_MESSAGES.BROWSER_BATCHED_MESSAGES, [messages]);
+  } catch {
+    // Some message could not be cloned, send them one at a time so that only
+    // that message is lost. The error is reported on its own, as it must not
+    // surface from whichever call happened to flush the batch.
+    for (const [channel, args] of messages) {
+      try {
+        ipc.send(internal, channel, args);
+      } catch (error) {
+        queueMicrotask(() => { throw error; });
+      }
+    }
+  }
+};
+
 const ipcRenderer = new EventEmitter() as Electron.IpcRenderer;
 ipcRenderer.send = function (channel, ...args) {
+  flushBatchedMessages();
   return ipc.send(internal, channel, args);
 };
 
+ipcRenderer.sendBatched = function (channel, ...args) {
+  if (typeof channel !== 'string') {
+    throw new Error('Missing required channel argument');
+  }
+  if (batchedMessages.length === 0) {
+    queueMicrotask(flushBatchedMessages);
+  }
+  batchedMessages.push([channel, args]);
+};
+
 ipcRenderer.sendSync = function (channel, ...args) {
+  flushBatchedMessages();
   return ipc.sendSync(internal, channel, args);
 };
 
 ipcRenderer.sendToHost = function (channel, ...args) {
+  flushBatchedMessages();
   return ipc.sendToHost(channel, args);
 };
 
 ipcRenderer.sendTo = function (webContentsId, channel, ...args) {
+  flushBatchedMessages();
   return ipc.sendTo(internal, webContentsId, channel, args);
 };
 
 ipcRenderer.invoke = async function (channel, ...args) {
+  flushBatchedMessages();
   const { error, result } = await ipc.invoke(internal, channel, args);
   if (error) {
     throw new Error(`Error invoking remote method '${channel}': ${error}`);
@@ -29,7 +71,36 @@ ipcRenderer.invoke = async function (channel, ...args) {
   return result;
 };
 
+ipcRenderer.getSharedValue = function (key) {
+  return ipc.getSharedValue(key);
+};
+
+let nextConnectId = 0;
+
+ipcRenderer.connectTo = function (webContentsId, channel) {
+  flushBatchedMessages();
+  return new Promise<MessagePort>((resolve, reject) => {
+    const requestId = ++nextConnectId;
+    ipcRendererInternal.once(`${IPC_MESSAGES.BROWSER_CONNECT_TO}_RESPONSE_${requestId}`, (event, error: string | null) => {
+      if (error) {
+        reject(new Error(error));
+      } else {
+        resolve(event.ports[0]);
+      }
+    });
+    ipcRendererInternal.send(IPC_MESSAGES.BROWSER_CONNECT_TO, requestId, webContentsId, channel);
+  });
+};
+
+// The other end of a connection made by ipcRenderer.connectTo() in another
+// renderer. It arrives on an internal channel, so that a page can tell it
+// apart from messages sent by the main process.
+ipcRendererInternal.on(IPC_MESSAGES.RENDERER_CONNECT_FROM, (event, { senderId, channel }: { senderId: number, channel: string }) => {
+  ipcRenderer.emit(channel, { sender: ipcRenderer, senderId, ports: event.ports });
+});
+
 ipcRenderer.postMessage = function (channel: string, message: any, transferables: any) {
+  flushBatchedMessages();
   return ipc.postMessage(channel, message, transferables);
 };
 
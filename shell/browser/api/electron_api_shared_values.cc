@@ -0,0 +1,63 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "gin/dictionary.h"
+#include "gin/handle.h"
+#include "shell/browser/api/electron_api_session.h"
+#include "shell/browser/electron_browser_context.h"
+#include "shell/browser/shared_value_store.h"
+#include "shell/common/gin_helper/error_thrower.h"
+#include "shell/common/node_includes.h"
+#include "shell/common/v8_value_serializer.h"
+#include "third_party/blink/public/common/messaging/cloneable_message.h"
+
+namespace {
+
+void SetSharedValue(v8::Isolate* isolate,
+                    gin_helper::ErrorThrower thrower,
+                    const std::string& key,
+                    v8::Local<v8::Value> value,
+                    v8::Local<v8::Value> session_value) {
+  // Values published for a session are only visible to its renderers.
+  const void* scope = nullptr;
+  if (!session_value->IsNullOrUndefined()) {
+    gin::Handle<electron::api::Session> session;
+    if (!gin::ConvertFromV8(isolate, session_value, &session) ||
+        session.IsEmpty()) {
+      thrower.ThrowTypeError("Expected session to be a Session");
+      return;
+    }
+    scope = session->browser_context();
+  }
+
+  blink::CloneableMessage message;
+  if (!electron::SerializeV8Value(isolate, value, &message)) {
+    // SerializeV8Value sets an exception.
+    return;
+  }
+  if (!electron::SharedValueStore::GetInstance()->Set(
+          scope, key, message.encoded_message)) {
+    thrower.ThrowError("Failed to publish the value");
+  }
+}
+
+void DeleteSharedValue(const std::string& key) {
+  electron::SharedValueStore::GetInstance()->Delete(key);
+}
+
+void Initialize(v8::Local<v8::Object> exports,
+                v8::Local<v8::Value> unused,
+                v8::Local<v8::Context> context,
+                void* priv) {
+  v8::Isolate* isolate = context->GetIsolate();
+  gin::Dictionary dict(isolate, exports);
+  dict.SetMethod("setSharedValue", &SetSharedValue);
+  dict.SetMethod("deleteSharedValue", &DeleteSharedValue);
+}
+
+}  // namespace
+
+NODE_LINKED_MODULE_CONTEXT_AWARE(electron_browser_shared_values, Initialize)
@@ -67,6 +67,7 @@
 #include "gin/handle.h"
 #include "gin/object_template_builder.h"
 #include "gin/wrappable.h"
+#include "media/media_buildflags.h"
 #include "mojo/public/cpp/bindings/associated_remote.h"
 #include "mojo/public/cpp/bindings/pending_receiver.h"
 #include "mojo/public/cpp/bindings/remote.h"
@@ -137,6 +138,7 @@
 #include "ui/events/base_event_utils.h"
 
 #if BUILDFLAG(ENABLE_OSR)
+#include "shell/browser/api/offscreen_frame_ring.h"
 #include "shell/browser/osr/osr_render_widget_host_view.h"
 #include "shell/browser/osr/osr_web_contents_view.h"
 #endif
@@ -1545,10 +1547,20 @@ bool WebContents::EmitNavigationEvent(
 void WebContents::Message(bool internal,
                           const std::string& channel,
                           blink::CloneableMessage arguments,
+                          mojom::SharedMessagePayloadPtr shared_arguments,
                           content::RenderFrameHost* render_frame_host) {
   TRACE_EVENT1("electron", "WebContents::Message", "channel", channel);
   // webContents.emit('-ipc-message', new Event(), internal, channel,
   // arguments);
+  if (shared_arguments) {
+    v8::Isolate* isolate = JavascriptEnvironment::GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+    EmitWithSender("-ipc-message", render_frame_host,
+                   electron::mojom::ElectronBrowser::InvokeCallback(),
+                   internal, channel,
+                   electron::DeserializeV8Value(isolate, *shared_arguments));
+    return;
+  }
   EmitWithSender("-ipc-message", render_frame_host,
                  electron::mojom::ElectronBrowser::InvokeCallback(), internal,
                  channel, std::move(arguments));
@@ -1558,10 +1570,19 @@ void WebContents::Invoke(
     bool internal,
     const std::string& channel,
     blink::CloneableMessage arguments,
+    mojom::SharedMessagePayloadPtr shared_arguments,
     electron::mojom::ElectronBrowser::InvokeCallback callback,
     content::RenderFrameHost* render_frame_host) {
   TRACE_EVENT1("electron", "WebContents::Invoke", "channel", channel);
   // webContents.emit('-ipc-invoke', new Event(), internal, channel, arguments);
+  if (shared_arguments) {
+    v8::Isolate* isolate = JavascriptEnvironment::GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+    EmitWithSender("-ipc-invoke", render_frame_host, std::move(callback),
+                   internal, channel,
+                   electron::DeserializeV8Value(isolate, *shared_arguments));
+    return;
+  }
   EmitWithSender("-ipc-invoke", render_frame_host, std::move(callback),
                  internal, channel, std::move(arguments));
 }
@@ -1582,7 +1603,7 @@ void WebContents::ReceivePostMessage(
   auto wrapped_ports =
       MessagePort::EntanglePorts(isolate, std::move(message.ports));
   v8::Local<v8::Value> message_value =
-      electron::DeserializeV8Value(isolate, message);
+      electron::DeserializeV8Value(isolate, &message);
   EmitWithSender("-ipc-ports", render_frame_host,
                  electron::mojom::ElectronBrowser::InvokeCallback(), false,
                  channel, message_value, std::move(wrapped_ports));
@@ -2772,22 +2793,80 @@ void WebContents::SendInputEvent(v8::Isolate* isolate,
 }
 
 void WebContents::BeginFrameSubscription(gin::Arguments* args) {
-  bool only_dirty = false;
+  FrameSubscriber::Options options;
   FrameSubscriber::FrameCaptureCallback callback;
 
-  if (args->Length() > 1) {
-    if (!args->GetNext(&only_dirty)) {
-      args->ThrowError();
+  v8::Local<v8::Value> next = args->PeekNext();
+  if (!next.IsEmpty() && next->IsObject() && !next->IsFunction()) {
+    gin_helper::Dictionary dict;
+    args->GetNext(&dict);
+    dict.Get("onlyDirty", &options.only_dirty);
+    if (dict.Get("frameRate", &options.frame_rate) &&
+        (options.frame_rate < 1 || options.frame_rate > 240)) {
+      args->ThrowTypeError("frameRate must be between 1 and 240");
       return;
     }
-  }
-  if (!args->GetNext(&callback)) {
+    std::string pixel_format;
+    if (dict.Get("pixelFormat", &pixel_format)) {
+      if (pixel_format == "i420") {
+        options.pixel_format = media::PIXEL_FORMAT_I420;
+      } else if (pixel_format != "argb") {
+        args->ThrowTypeError("pixelFormat must be 'argb' or 'i420'");
+        return;
+      }
+    }
+    if (dict.Get("size", &options.size) && options.size.IsEmpty()) {
+      args->ThrowTypeError("size must not be empty");
+      return;
+    }
+    std::string codec;
+    if (dict.Get("codec", &codec)) {
+#if BUILDFLAG(ENABLE_LIBVPX)
+      if (codec == "vp8") {
+        options.codec_profile = media::VP8PROFILE_ANY;
+      } else if (codec == "vp9") {
+        options.codec_profile = media::VP9PROFILE_PROFILE0;
+      } else {
+        args->ThrowTypeError("codec must be 'vp8' or 'vp9'");
+        return;
+      }
+      double bitrate = 0;
+      if (dict.Get("bitrate", &bitrate) && bitrate > 0)
+        options.bitrate = static_cast<uint64_t>(bitrate);
+#else
+      args->ThrowTypeError("Frame encoding is not supported in this build");
+      return;
+#endif
+    }
+  } else if (!next.IsEmpty() && next->IsBoolean()) {
+    args->GetNext(&options.only_dirty);
+  }
+  // I420 frames and encoded packets are emitted as events, so the callback
+  // is only required for ARGB frames.
+  bool needs_callback =
+      options.pixel_format == media::PIXEL_FORMAT_ARGB &&
+      options.codec_profile == media::VIDEO_CODEC_PROFILE_UNKNOWN;
+  if (!args->GetNext(&callback) && needs_callback) {
     args->ThrowError();
     return;
   }
 
-  frame_subscriber_ =
-      std::make_unique<FrameSubscriber>(web_contents(), callback, only_dirty);
+  frame_subscriber_ = std::make_unique<FrameSubscriber>(
+      web_contents(), callback,
+      base::BindRepeating(&WebContents::OnCapturedVideoFrame,
+                          base::Unretained(this)),
+      base::BindRepeating(&WebContents::OnEncodedVideoPacket,
+                          base::Unretained(this)),
+      options);
+}
+
+void WebContents::OnCapturedVideoFrame(v8::Local<v8::Value> frame,
+                                       const gfx::Rect& dirty_rect) {
+  Emit("captured-video-frame", frame, dirty_rect);
+}
+
+void WebContents::OnEncodedVideoPacket(v8::Local<v8::Value> packet) {
+  Emit("encoded-video-packet", packet);
 }
 
 void WebContents::EndFrameSubscription() {
@@ -2939,6 +3018,15 @@ bool WebContents::IsOffScreen() const {
 
 #if BUILDFLAG(ENABLE_OSR)
 void WebContents::OnPaint(const gfx::Rect& dirty_rect, const SkBitmap& bitmap) {
+  if (frame_ring_) {
+    v8::Isolate* isolate = JavascriptEnvironment::GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Value> frame =
+        frame_ring_->Acquire(isolate, dirty_rect, bitmap);
+    if (!frame.IsEmpty())
+      Emit("paint-frame", frame);
+    return;
+  }
   Emit("paint", dirty_rect, gfx::Image::CreateFrom1xBitmap(bitmap));
 }
 
@@ -2969,6 +3057,21 @@ int WebContents::GetFrameRate() const {
   auto* osr_wcv = GetOffScreenWebContentsView();
   return osr_wcv ? osr_wcv->GetFrameRate() : 0;
 }
+
+void WebContents::SetFrameRingSize(int size) {
+  auto* osr_wcv = GetOffScreenWebContentsView();
+  if (!osr_wcv)
+    return;
+
+  if (size > 0)
+    frame_ring_ = std::make_unique<OffscreenFrameRing>(
+        size, base::BindRepeating(&WebContents::Invalidate, GetWeakPtr()));
+  else
+    frame_ring_.reset();
+  // Frames are copied into the ring, so the view no longer needs its own
+  // copy of every captured frame.
+  osr_wcv->SetShareCapturedPixels(frame_ring_ != nullptr);
+}
 #endif
 
 void WebContents::Invalidate() {
@@ -3655,6 +3758,7 @@ v8::Local<v8::ObjectTemplate> WebContents::FillObjectTemplate(
       .SetMethod("isPainting", &WebContents::IsPainting)
       .SetMethod("setFrameRate", &WebContents::SetFrameRate)
       .SetMethod("getFrameRate", &WebContents::GetFrameRate)
+      .SetMethod("setFrameRingSize", &WebContents::SetFrameRingSize)
 #endif
       .SetMethod("invalidate", &WebContents::Invalidate)
       .SetMethod("setZoomLevel", &WebContents::SetZoomLevel)
@@ -3829,6 +3933,55 @@ std::vector<gin::Handle<WebContents>> GetAllWebContentsAsV8(
   return list;
 }
 
+int Broadcast(v8::Isolate* isolate,
+              const std::string& channel,
+              v8::Local<v8::Value> value,
+              gin::Arguments* args) {
+  gin_helper::Dictionary options = gin::Dictionary::CreateEmpty(isolate);
+  args->GetNext(&options);
+  content::BrowserContext* browser_context = nullptr;
+  gin::Handle<electron::api::Session> session;
+  if (options.Get("session", &session) && !session.IsEmpty())
+    browser_context = session->browser_context();
+  bool all_frames = false;
+  options.Get("allFrames", &all_frames);
+
+  // Serialize once, every frame is sent the same encoded arguments.
+  blink::CloneableMessage message;
+  if (!electron::SerializeV8Value(isolate, v8::Array::New(isolate, &value, 1),
+                                  &message)) {
+    // SerializeV8Value sets an exception.
+    return 0;
+  }
+
+  int count = 0;
+  for (auto iter = base::IDMap<WebContents*>::iterator(&GetAllWebContents());
+       !iter.IsAtEnd(); iter.Advance()) {
+    content::WebContents* web_contents =
+        iter.GetCurrentValue()->web_contents();
+    if (!web_contents)
+      continue;
+    if (browser_context && web_contents->GetBrowserContext() != browser_context)
+      continue;
+
+    std::vector<content::RenderFrameHost*> frames;
+    if (all_frames)
+      frames = web_contents->GetAllFrames();
+    else
+      frames.push_back(web_contents->GetMainFrame());
+    for (content::RenderFrameHost* frame : frames) {
+      if (!frame->IsRenderFrameLive())
+        continue;
+      electron::api::WebFrameMain::From(isolate, frame)
+          ->GetRendererApi()
+          ->Message(false /* internal */, channel, message.ShallowClone(),
+                    0 /* sender_id */);
+      ++count;
+    }
+  }
+  return count;
+}
+
 void Initialize(v8::Local<v8::Object> exports,
                 v8::Local<v8::Value> unused,
                 v8::Local<v8::Context> context,
@@ -3838,6 +3991,7 @@ void Initialize(v8::Local<v8::Object> exports,
   dict.Set("WebContents", WebContents::GetConstructor(context));
   dict.SetMethod("fromId", &WebContentsFromID);
   dict.SetMethod("getAllWebContents", &GetAllWebContentsAsV8);
+  dict.SetMethod("broadcast", &Broadcast);
 }
 
 }  // namespace
@@ -90,6 +90,10 @@ class OffScreenWebContentsView;
 
 namespace api {
 
+#if BUILDFLAG(ENABLE_OSR)
+class OffscreenFrameRing;
+#endif
+
 // Wrapper around the content::WebContents.
 class WebContents : public gin::Wrappable<WebContents>,
                     public gin_helper::EventEmitterMixin<WebContents>,
@@ -252,6 +256,9 @@ class WebContents : public gin::Wrappable<WebContents>,
   // Subscribe to the frame updates.
   void BeginFrameSubscription(gin::Arguments* args);
   void EndFrameSubscription();
+  void OnCapturedVideoFrame(v8::Local<v8::Value> frame,
+                            const gfx::Rect& dirty_rect);
+  void OnEncodedVideoPacket(v8::Local<v8::Value> packet);
 
   // Dragging native items.
   void StartDrag(const gin_helper::Dictionary& item, gin::Arguments* args);
@@ -275,6 +282,7 @@ class WebContents : public gin::Wrappable<WebContents>,
   bool IsPainting() const;
   void SetFrameRate(int frame_rate);
   int GetFrameRate() const;
+  void SetFrameRingSize(int size);
 #endif
   void Invalidate();
   gfx::Size GetSizeForNewRenderView(content::WebContents*) override;
@@ -393,10 +401,12 @@ class WebContents : public gin::Wrappable<WebContents>,
   void Message(bool internal,
                const std::string& channel,
                blink::CloneableMessage arguments,
+               mojom::SharedMessagePayloadPtr shared_arguments,
                content::RenderFrameHost* render_frame_host);
   void Invoke(bool internal,
               const std::string& channel,
               blink::CloneableMessage arguments,
+              mojom::SharedMessagePayloadPtr shared_arguments,
               electron::mojom::ElectronBrowser::InvokeCallback callback,
               content::RenderFrameHost* render_frame_host);
   void OnFirstNonEmptyLayout(content::RenderFrameHost* render_frame_host);
@@ -692,6 +702,11 @@ class WebContents : public gin::Wrappable<WebContents>,
   std::unique_ptr<WebViewGuestDelegate> guest_delegate_;
   std::unique_ptr<FrameSubscriber> frame_subscriber_;
 
+#if BUILDFLAG(ENABLE_OSR)
+  // Delivers offscreen frames through "paint-frame" instead of "paint".
+  std::unique_ptr<OffscreenFrameRing> frame_ring_;
+#endif
+
 #if BUILDFLAG(ENABLE_ELECTRON_EXTENSIONS)
   std::unique_ptr<extensions::ScriptExecutor> script_executor_;
 #endif
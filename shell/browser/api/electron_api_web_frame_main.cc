@@ -180,25 +180,41 @@ void WebFrameMain::OnRendererConnectionError() {
 }
 
 void WebFrameMain::PostMessage(v8::Isolate* isolate,
+                               bool internal,
                                const std::string& channel,
                                v8::Local<v8::Value> message_value,
                                absl::optional<v8::Local<v8::Value>> transfer) {
-  blink::TransferableMessage transferable_message;
-  if (!electron::SerializeV8Value(isolate, message_value,
-                                  &transferable_message)) {
-    // SerializeV8Value sets an exception.
-    return;
+  std::vector<v8::Local<v8::Value>> transferables;
+  if (transfer) {
+    if (!gin::ConvertFromV8(isolate, *transfer, &transferables)) {
+      isolate->ThrowException(v8::Exception::Error(
+          gin::StringToV8(isolate, "Invalid value for transfer")));
+      return;
+    }
   }
 
+  std::vector<v8::Local<v8::ArrayBuffer>> array_buffers;
   std::vector<gin::Handle<MessagePort>> wrapped_ports;
-  if (transfer) {
-    if (!gin::ConvertFromV8(isolate, *transfer, &wrapped_ports)) {
+  for (auto& transferable : transferables) {
+    gin::Handle<MessagePort> port;
+    if (transferable->IsArrayBuffer()) {
+      array_buffers.push_back(transferable.As<v8::ArrayBuffer>());
+    } else if (gin::ConvertFromV8(isolate, transferable, &port)) {
+      wrapped_ports.push_back(port);
+    } else {
       isolate->ThrowException(v8::Exception::Error(
           gin::StringToV8(isolate, "Invalid value for transfer")));
       return;
     }
   }
 
+  blink::TransferableMessage transferable_message;
+  if (!electron::SerializeV8Value(isolate, message_value, array_buffers,
+                                  &transferable_message)) {
+    // SerializeV8Value sets an exception.
+    return;
+  }
+
   bool threw_exception = false;
   transferable_message.ports =
       MessagePort::DisentanglePorts(isolate, wrapped_ports, &threw_exception);
@@ -208,7 +224,7 @@ void WebFrameMain::PostMessage(v8::Isolate* isolate,
   if (!CheckRenderFrame())
     return;
 
-  GetRendererApi()->ReceivePostMessage(channel,
+  GetRendererApi()->ReceivePostMessage(internal, channel,
                                        std::move(transferable_message));
 }
 
@@ -86,6 +86,7 @@ class WebFrameMain : public gin::Wrappable<WebFrameMain>,
             const std::string& channel,
             v8::Local<v8::Value> args);
   void PostMessage(v8::Isolate* isolate,
+                   bool internal,
                    const std::string& channel,
                    v8::Local<v8::Value> message_value,
                    absl::optional<v8::Local<v8::Value>> transfer);
@@ -4,29 +4,67 @@
 
 #include "shell/browser/api/frame_subscriber.h"
 
+#include <cstring>
+#include <memory>
 #include <utility>
 
+#include "base/callback_helpers.h"
 #include "content/public/browser/render_view_host.h"
 #include "content/public/browser/render_widget_host.h"
 #include "content/public/browser/render_widget_host_view.h"
+#include "gin/dictionary.h"
+#include "media/base/video_frame.h"
 #include "media/capture/mojom/video_capture_types.mojom.h"
+#include "media/media_buildflags.h"
 #include "mojo/public/cpp/bindings/remote.h"
+#include "shell/browser/javascript_environment.h"
+#include "shell/common/node_includes.h"
 #include "ui/gfx/geometry/size_conversions.h"
 #include "ui/gfx/image/image.h"
-#include "ui/gfx/skbitmap_operations.h"
+#include "ui/gfx/skia_util.h"
+
+#if BUILDFLAG(ENABLE_LIBVPX)
+#include "media/video/offloading_video_encoder.h"  // nogncheck
+#include "media/video/vpx_video_encoder.h"         // nogncheck
+#endif
 
 namespace electron {
 
 namespace api {
 
-constexpr static int kMaxFrameRate = 30;
+namespace {
+
+// Keeps a captured frame alive until its consumer is done with it.  The
+// capturer only has a small pool of buffers, so frames that are held for
+// too long make it drop new ones instead of queueing them.
+struct FramePinner {
+  // Keeps the shared memory that backs the frame mapped.
+  base::ReadOnlySharedMemoryMapping mapping;
+  // Prevents FrameSinkVideoCapturer from recycling the shared memory that
+  // backs the frame.
+  mojo::Remote<viz::mojom::FrameSinkVideoConsumerFrameCallbacks> releaser;
+};
+
+void FreeEncodedData(char* data, void* hint) {
+  delete[] reinterpret_cast<uint8_t*>(data);
+}
+
+}  // namespace
 
-FrameSubscriber::FrameSubscriber(content::WebContents* web_contents,
-                                 const FrameCaptureCallback& callback,
-                                 bool only_dirty)
+FrameSubscriber::FrameSubscriber(
+    content::WebContents* web_contents,
+    const FrameCaptureCallback& callback,
+    const VideoFrameCallback& video_frame_callback,
+    const VideoPacketCallback& video_packet_callback,
+    const Options& options)
     : content::WebContentsObserver(web_contents),
       callback_(callback),
-      only_dirty_(only_dirty) {
+      video_frame_callback_(video_frame_callback),
+      video_packet_callback_(video_packet_callback),
+      options_(options) {
+  // The encoders only take planar frames.
+  if (options_.codec_profile != media::VIDEO_CODEC_PROFILE_UNKNOWN)
+    options_.pixel_format = media::PIXEL_FORMAT_I420;
   content::RenderViewHost* rvh = web_contents->GetRenderViewHost();
   if (rvh)
     AttachToHost(rvh->GetWidget());
@@ -43,15 +81,15 @@ void FrameSubscriber::AttachToHost(content::RenderWidgetHost* host) {
     return;
 
   // Create and configure the video capturer.
-  gfx::Size size = GetRenderViewSize();
+  gfx::Size size = GetCaptureSize();
   video_capturer_ = host_->GetView()->CreateVideoCapturer();
   video_capturer_->SetResolutionConstraints(size, size, true);
   video_capturer_->SetAutoThrottlingEnabled(false);
   video_capturer_->SetMinSizeChangePeriod(base::TimeDelta());
-  video_capturer_->SetFormat(media::PIXEL_FORMAT_ARGB,
+  video_capturer_->SetFormat(options_.pixel_format,
                              gfx::ColorSpace::CreateREC709());
   video_capturer_->SetMinCapturePeriod(base::TimeDelta::FromSeconds(1) /
-                                       kMaxFrameRate);
+                                       options_.frame_rate);
   video_capturer_->Start(this);
 }
 
@@ -88,8 +126,8 @@ void FrameSubscriber::OnFrameCaptured(
     const gfx::Rect& content_rect,
     mojo::PendingRemote<viz::mojom::FrameSinkVideoConsumerFrameCallbacks>
         callbacks) {
-  gfx::Size size = GetRenderViewSize();
-  if (size != content_rect.size()) {
+  gfx::Size size = GetCaptureSize();
+  if (options_.size.IsEmpty() && size != content_rect.size()) {
     video_capturer_->SetResolutionConstraints(size, size, true);
     video_capturer_->RequestRefreshFrame();
     return;
@@ -115,29 +153,50 @@ void FrameSubscriber::OnFrameCaptured(
   // The SkBitmap's pixels will be marked as immutable, but the installPixels()
   // API requires a non-const pointer. So, cast away the const.
   void* const pixels = const_cast<void*>(mapping.memory());
+  size_t mapping_size = mapping.size();
+
+  auto pinner = std::make_unique<FramePinner>(
+      FramePinner{std::move(mapping), std::move(callbacks_remote)});
+
+  if (info->pixel_format != media::PIXEL_FORMAT_ARGB) {
+    scoped_refptr<media::VideoFrame> frame =
+        media::VideoFrame::WrapExternalData(
+            info->pixel_format, info->coded_size, info->visible_rect,
+            info->visible_rect.size(), static_cast<const uint8_t*>(pixels),
+            mapping_size, info->timestamp);
+    if (!frame)
+      return;
+    // The capturer gets its buffer back once the last reference to |frame|,
+    // possibly held by the encoder, goes away.
+    frame->AddDestructionObserver(
+        base::BindOnce(&base::DeletePointer<FramePinner>, pinner.release()));
+
+    if (options_.codec_profile != media::VIDEO_CODEC_PROFILE_UNKNOWN)
+      Encode(std::move(frame));
+    else
+      DoneYUV(content_rect, *frame);
+    return;
+  }
 
   // Call installPixels() with a |releaseProc| that: 1) notifies the capturer
   // that this consumer has finished with the frame, and 2) releases the shared
-  // memory mapping.
-  struct FramePinner {
-    // Keeps the shared memory that backs |frame_| mapped.
-    base::ReadOnlySharedMemoryMapping mapping;
-    // Prevents FrameSinkVideoCapturer from recycling the shared memory that
-    // backs |frame_|.
-    mojo::Remote<viz::mojom::FrameSinkVideoConsumerFrameCallbacks> releaser;
-  };
-
+  // memory mapping.  The bitmap covers the whole output, which is larger than
+  // |content_rect| when a fixed size letterboxes the page.
+  const gfx::Rect& visible_rect = info->visible_rect;
+  size_t row_bytes = media::VideoFrame::RowBytes(
+      media::VideoFrame::kARGBPlane, info->pixel_format,
+      info->coded_size.width());
   SkBitmap bitmap;
   bitmap.installPixels(
-      SkImageInfo::MakeN32(content_rect.width(), content_rect.height(),
+      SkImageInfo::MakeN32(visible_rect.width(), visible_rect.height(),
                            kPremul_SkAlphaType),
-      pixels,
-      media::VideoFrame::RowBytes(media::VideoFrame::kARGBPlane,
-                                  info->pixel_format, info->coded_size.width()),
+      static_cast<uint8_t*>(pixels) + visible_rect.y() * row_bytes +
+          visible_rect.x() * SkColorTypeBytesPerPixel(kN32_SkColorType),
+      row_bytes,
       [](void* addr, void* context) {
         delete static_cast<FramePinner*>(context);
       },
-      new FramePinner{std::move(mapping), std::move(callbacks_remote)});
+      pinner.release());
   bitmap.setImmutable();
 
   Done(content_rect, bitmap);
@@ -151,24 +210,133 @@ void FrameSubscriber::Done(const gfx::Rect& damage, const SkBitmap& frame) {
   if (frame.drawsNothing())
     return;
 
-  const SkBitmap& bitmap = only_dirty_ ? SkBitmapOperations::CreateTiledBitmap(
-                                             frame, damage.x(), damage.y(),
-                                             damage.width(), damage.height())
-                                       : frame;
+  SkIRect area = options_.only_dirty
+                     ? gfx::RectToSkIRect(damage)
+                     : SkIRect::MakeWH(frame.width(), frame.height());
 
   // Copying SkBitmap does not copy the internal pixels, we have to manually
   // allocate and write pixels otherwise crash may happen when the original
-  // frame is modified.
-  SkBitmap copy;
-  copy.allocPixels(SkImageInfo::Make(bitmap.width(), bitmap.height(),
-                                     kN32_SkColorType, kPremul_SkAlphaType));
+  // frame is modified.  Only the requested area is copied, and only once.
   SkPixmap pixmap;
-  bool success = bitmap.peekPixels(&pixmap) && copy.writePixels(pixmap, 0, 0);
+  SkPixmap subset;
+  SkBitmap copy;
+  bool success = frame.peekPixels(&pixmap) &&
+                 pixmap.extractSubset(&subset, area) &&
+                 copy.tryAllocPixels(SkImageInfo::Make(
+                     subset.width(), subset.height(), kN32_SkColorType,
+                     kPremul_SkAlphaType)) &&
+                 copy.writePixels(subset, 0, 0);
   CHECK(success);
 
   callback_.Run(gfx::Image::CreateFrom1xBitmap(copy), damage);
 }
 
+void FrameSubscriber::DoneYUV(const gfx::Rect& damage,
+                              const media::VideoFrame& frame) {
+  // Pack the visible part of each plane without row padding. row_bytes()
+  // covers the coded width, which can be wider than the visible one.
+  const media::VideoPixelFormat format = frame.format();
+  const gfx::Rect& visible_rect = frame.visible_rect();
+  size_t size = 0;
+  for (size_t plane = 0; plane < media::VideoFrame::NumPlanes(format);
+       ++plane) {
+    size += media::VideoFrame::Rows(plane, format, visible_rect.height()) *
+            media::VideoFrame::RowBytes(plane, format, visible_rect.width());
+  }
+
+  v8::Isolate* isolate = JavascriptEnvironment::GetIsolate();
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::Object> buffer;
+  if (!node::Buffer::New(isolate, size).ToLocal(&buffer))
+    return;
+
+  char* dest = node::Buffer::Data(buffer);
+  for (size_t plane = 0; plane < media::VideoFrame::NumPlanes(format);
+       ++plane) {
+    int rows = media::VideoFrame::Rows(plane, format, visible_rect.height());
+    int row_bytes =
+        media::VideoFrame::RowBytes(plane, format, visible_rect.width());
+    const uint8_t* src = frame.visible_data(plane);
+    for (int row = 0; row < rows; ++row) {
+      memcpy(dest, src, row_bytes);
+      dest += row_bytes;
+      src += frame.stride(plane);
+    }
+  }
+
+  gin::Dictionary dict = gin::Dictionary::CreateEmpty(isolate);
+  dict.Set("format", "i420");
+  dict.Set("width", visible_rect.width());
+  dict.Set("height", visible_rect.height());
+  dict.Set("data", buffer);
+  video_frame_callback_.Run(dict.GetHandle(), damage);
+}
+
+void FrameSubscriber::Encode(scoped_refptr<media::VideoFrame> frame) {
+#if BUILDFLAG(ENABLE_LIBVPX)
+  gfx::Size size = frame->visible_rect().size();
+  if (!encoder_ || encoder_size_ != size) {
+    // The encoder is rebuilt when the view is resized, which starts the new
+    // stream with a key frame.
+    encoder_ = std::make_unique<media::OffloadingVideoEncoder>(
+        std::make_unique<media::VpxVideoEncoder>());
+    encoder_size_ = size;
+
+    media::VideoEncoder::Options encoder_options;
+    encoder_options.frame_size = size;
+    encoder_options.framerate = options_.frame_rate;
+    if (options_.bitrate)
+      encoder_options.bitrate = options_.bitrate;
+    encoder_->Initialize(
+        options_.codec_profile, encoder_options,
+        base::BindRepeating(&FrameSubscriber::OnEncodedOutput,
+                            weak_ptr_factory_.GetWeakPtr()),
+        base::BindOnce(&FrameSubscriber::OnEncoderStatus,
+                       weak_ptr_factory_.GetWeakPtr()));
+  }
+
+  encoder_->Encode(std::move(frame), false,
+                   base::BindOnce(&FrameSubscriber::OnEncoderStatus,
+                                  weak_ptr_factory_.GetWeakPtr()));
+#endif
+}
+
+void FrameSubscriber::OnEncoderStatus(media::Status status) {
+  if (!status.is_ok()) {
+    DLOG(ERROR) << "Frame encoding failed: " << status.message();
+    // Start over with a new encoder on the next frame.
+    encoder_.reset();
+  }
+}
+
+void FrameSubscriber::OnEncodedOutput(
+    media::VideoEncoderOutput output,
+    absl::optional<media::VideoEncoder::CodecDescription> description) {
+  v8::Isolate* isolate = JavascriptEnvironment::GetIsolate();
+  v8::HandleScope handle_scope(isolate);
+
+  // The encoded packet is handed to JS without copying it, node frees it
+  // even when creating the Buffer fails.
+  char* data = reinterpret_cast<char*>(output.data.release());
+  v8::Local<v8::Object> buffer;
+  if (!node::Buffer::New(isolate, data, output.size, &FreeEncodedData, nullptr)
+           .ToLocal(&buffer))
+    return;
+
+  gin::Dictionary dict = gin::Dictionary::CreateEmpty(isolate);
+  dict.Set("codec", options_.codec_profile == media::VP8PROFILE_ANY
+                        ? "vp8"
+                        : "vp9");
+  dict.Set("data", buffer);
+  dict.Set("keyFrame", output.key_frame);
+  dict.Set("timestamp", output.timestamp.InMillisecondsF());
+  video_packet_callback_.Run(dict.GetHandle());
+}
+
+gfx::Size FrameSubscriber::GetCaptureSize() const {
+  return options_.size.IsEmpty() ? GetRenderViewSize() : options_.size;
+}
+
 gfx::Size FrameSubscriber::GetRenderViewSize() const {
   content::RenderWidgetHostView* view = host_->GetView();
   gfx::Size size = view->GetViewBounds().size();
@@ -13,13 +13,21 @@
 #include "components/viz/host/client_frame_sink_video_capturer.h"
 #include "content/public/browser/web_contents.h"
 #include "content/public/browser/web_contents_observer.h"
+#include "media/base/video_codecs.h"
+#include "media/base/video_encoder.h"
+#include "media/base/video_types.h"
 #include "mojo/public/cpp/bindings/pending_remote.h"
+#include "ui/gfx/geometry/size.h"
 #include "v8/include/v8.h"
 
 namespace gfx {
 class Image;
 }
 
+namespace media {
+class VideoFrame;
+}
+
 namespace electron {
 
 namespace api {
@@ -29,12 +37,34 @@ class WebContents;
 class FrameSubscriber : public content::WebContentsObserver,
                         public viz::mojom::FrameSinkVideoConsumer {
  public:
+  // Called with the image of ARGB frames.
   using FrameCaptureCallback =
       base::RepeatingCallback<void(const gfx::Image&, const gfx::Rect&)>;
+  // Called with a CapturedVideoFrame object for I420 frames.
+  using VideoFrameCallback =
+      base::RepeatingCallback<void(v8::Local<v8::Value>, const gfx::Rect&)>;
+  // Called with an EncodedVideoPacket object for encoded frames.
+  using VideoPacketCallback =
+      base::RepeatingCallback<void(v8::Local<v8::Value>)>;
+
+  struct Options {
+    bool only_dirty = false;
+    int frame_rate = 30;
+    media::VideoPixelFormat pixel_format = media::PIXEL_FORMAT_ARGB;
+    // Fixed output size in pixels, follows the view when empty.
+    gfx::Size size;
+    // Frames are encoded when this is a VP8 or VP9 profile.
+    media::VideoCodecProfile codec_profile =
+        media::VIDEO_CODEC_PROFILE_UNKNOWN;
+    // Target bitrate of the encoder in bits per second, 0 picks a default.
+    uint64_t bitrate = 0;
+  };
 
   FrameSubscriber(content::WebContents* web_contents,
                   const FrameCaptureCallback& callback,
-                  bool only_dirty);
+                  const VideoFrameCallback& video_frame_callback,
+                  const VideoPacketCallback& video_packet_callback,
+                  const Options& options);
   ~FrameSubscriber() override;
 
  private:
@@ -57,16 +87,32 @@ class FrameSubscriber : public content::WebContentsObserver,
   void OnLog(const std::string& message) override;
 
   void Done(const gfx::Rect& damage, const SkBitmap& frame);
+  void DoneYUV(const gfx::Rect& damage, const media::VideoFrame& frame);
+
+  void Encode(scoped_refptr<media::VideoFrame> frame);
+  void OnEncoderStatus(media::Status status);
+  void OnEncodedOutput(
+      media::VideoEncoderOutput output,
+      absl::optional<media::VideoEncoder::CodecDescription> description);
 
   // Get the pixel size of render view.
   gfx::Size GetRenderViewSize() const;
 
+  // Get the size frames are captured at.
+  gfx::Size GetCaptureSize() const;
+
   FrameCaptureCallback callback_;
-  bool only_dirty_;
+  VideoFrameCallback video_frame_callback_;
+  VideoPacketCallback video_packet_callback_;
+  Options options_;
 
   content::RenderWidgetHost* host_;
   std::unique_ptr<viz::ClientFrameSinkVideoCapturer> video_capturer_;
 
+  std::unique_ptr<media::VideoEncoder> encoder_;
+  // The frame size |encoder_| was configured for.
+  gfx::Size encoder_size_;
+
   base::WeakPtrFactory<FrameSubscriber> weak_ptr_factory_{this};
 
   DISALLOW_COPY_AND_ASSIGN(FrameSubscriber);
@@ -237,7 +237,7 @@ bool MessagePort::Accept(mojo::Message* mojo_message) {
 
   auto ports = EntanglePorts(isolate, std::move(message.ports));
 
-  v8::Local<v8::Value> message_value = DeserializeV8Value(isolate, message);
+  v8::Local<v8::Value> message_value = DeserializeV8Value(isolate, &message);
 
   v8::Local<v8::Object> self;
   if (!GetWrapper(isolate).ToLocal(&self))
@@ -0,0 +1,127 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/api/offscreen_frame_ring.h"
+
+#include "base/bind.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "shell/common/gin_converters/callback_converter.h"
+#include "shell/common/gin_converters/gfx_converter.h"
+#include "shell/common/gin_helper/dictionary.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+
+namespace electron {
+
+namespace api {
+
+OffscreenFrameRing::OffscreenFrameRing(
+    size_t size,
+    const base::RepeatingClosure& frames_dropped_callback)
+    : frames_dropped_callback_(frames_dropped_callback) {
+  for (size_t i = 0; i < size; ++i) {
+    auto slot = std::make_unique<Slot>();
+    slot->ring = this;
+    slot->index = i;
+    slots_.push_back(std::move(slot));
+  }
+}
+
+OffscreenFrameRing::~OffscreenFrameRing() = default;
+
+v8::Local<v8::Value> OffscreenFrameRing::Acquire(v8::Isolate* isolate,
+                                                 const gfx::Rect& dirty_rect,
+                                                 const SkBitmap& bitmap) {
+  pending_damage_.Union(dirty_rect);
+  if (bitmap.drawsNothing())
+    return v8::Local<v8::Value>();
+
+  Slot* slot = nullptr;
+  for (auto& candidate : slots_) {
+    if (!candidate->in_use) {
+      slot = candidate.get();
+      break;
+    }
+  }
+  if (!slot) {
+    frames_dropped_ = true;
+    return v8::Local<v8::Value>();
+  }
+
+  SkImageInfo info =
+      SkImageInfo::MakeN32Premul(bitmap.width(), bitmap.height());
+  size_t byte_size = info.computeMinByteSize();
+  // The memory of a released frame may still be referenced elsewhere, for
+  // example when JS transferred its ArrayBuffer before releasing it, or V8 has
+  // not swept the collected ArrayBuffer yet. Never write into it then.
+  if (!slot->backing_store || slot->backing_store.use_count() != 1 ||
+      slot->backing_store->ByteLength() != byte_size)
+    slot->backing_store = v8::ArrayBuffer::NewBackingStore(isolate, byte_size);
+  if (!bitmap.readPixels(info, slot->backing_store->Data(), info.minRowBytes(),
+                         0, 0))
+    return v8::Local<v8::Value>();
+
+  v8::Local<v8::ArrayBuffer> buffer =
+      v8::ArrayBuffer::New(isolate, slot->backing_store);
+  slot->in_use = true;
+  slot->sequence = next_sequence_++;
+  slot->buffer.Reset(isolate, buffer);
+  slot->buffer.SetWeak(slot, &OffscreenFrameRing::OnBufferCollected,
+                       v8::WeakCallbackType::kParameter);
+
+  gfx::Rect frame_rect(bitmap.width(), bitmap.height());
+  gfx::Rect damage = gfx::IntersectRects(pending_damage_, frame_rect);
+  pending_damage_ = gfx::Rect();
+  frames_dropped_ = false;
+
+  gin_helper::Dictionary frame = gin::Dictionary::CreateEmpty(isolate);
+  frame.Set("sequence", static_cast<double>(slot->sequence));
+  frame.Set("data", buffer);
+  frame.Set("size", frame_rect.size());
+  frame.Set("dirtyRect", damage);
+  frame.Set("release",
+            base::BindRepeating(&OffscreenFrameRing::Release,
+                                weak_factory_.GetWeakPtr(), isolate,
+                                slot->index, slot->sequence));
+  return frame.GetHandle();
+}
+
+void OffscreenFrameRing::Release(v8::Isolate* isolate,
+                                 size_t index,
+                                 uint64_t sequence) {
+  Slot* slot = slots_[index].get();
+  // Releasing a frame twice, or after its slot was reused, does nothing.
+  if (!slot->in_use || slot->sequence != sequence)
+    return;
+
+  v8::HandleScope handle_scope(isolate);
+  if (!slot->buffer.IsEmpty())
+    slot->buffer.Get(isolate)->Detach();
+  slot->buffer.Reset();
+  slot->in_use = false;
+  OnSlotFreed();
+}
+
+// static
+void OffscreenFrameRing::OnBufferCollected(
+    const v8::WeakCallbackInfo<Slot>& data) {
+  Slot* slot = data.GetParameter();
+  slot->buffer.Reset();
+  slot->in_use = false;
+  slot->ring->OnSlotFreed();
+}
+
+void OffscreenFrameRing::OnSlotFreed() {
+  if (!frames_dropped_)
+    return;
+
+  // Slots are also freed from GC callbacks, which must not call into the
+  // renderer host, so ask for the new frame from a task.
+  frames_dropped_ = false;
+  base::ThreadTaskRunnerHandle::Get()->PostTask(FROM_HERE,
+                                                frames_dropped_callback_);
+}
+
+}  // namespace api
+
+}  // namespace electron
@@ -0,0 +1,84 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_API_OFFSCREEN_FRAME_RING_H_
+#define SHELL_BROWSER_API_OFFSCREEN_FRAME_RING_H_
+
+#include <memory>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/memory/weak_ptr.h"
+#include "ui/gfx/geometry/rect.h"
+#include "v8/include/v8.h"
+
+class SkBitmap;
+
+namespace electron {
+
+namespace api {
+
+// A fixed set of pixel buffers that offscreen paint frames are written into
+// and handed to JS as ArrayBuffers.  A buffer is reused once JS releases the
+// frame holding it and nothing else references its memory, so steady-state
+// painting allocates nothing and each frame is copied exactly once.  Frames
+// that arrive while every buffer is in use are dropped, and their damage is
+// merged into the next delivered frame.
+class OffscreenFrameRing {
+ public:
+  // |frames_dropped_callback| is run once a buffer frees up after frames were
+  // dropped, so that the owner can ask for a new frame carrying their damage
+  // instead of waiting for the next paint.
+  OffscreenFrameRing(size_t size,
+                     const base::RepeatingClosure& frames_dropped_callback);
+  ~OffscreenFrameRing();
+
+  size_t size() const { return slots_.size(); }
+
+  // Returns the JS object describing the frame, or an empty handle when the
+  // frame was dropped.
+  v8::Local<v8::Value> Acquire(v8::Isolate* isolate,
+                               const gfx::Rect& dirty_rect,
+                               const SkBitmap& bitmap);
+
+ private:
+  struct Slot {
+    OffscreenFrameRing* ring;
+    size_t index;
+    bool in_use = false;
+    uint64_t sequence = 0;
+    std::shared_ptr<v8::BackingStore> backing_store;
+    // The ArrayBuffer JS currently holds for this slot, weak so a frame that
+    // is garbage collected without being released frees its slot.
+    v8::Global<v8::ArrayBuffer> buffer;
+  };
+
+  void Release(v8::Isolate* isolate, size_t index, uint64_t sequence);
+
+  static void OnBufferCollected(const v8::WeakCallbackInfo<Slot>& data);
+
+  // Called whenever a slot is freed.
+  void OnSlotFreed();
+
+  std::vector<std::unique_ptr<Slot>> slots_;
+  uint64_t next_sequence_ = 0;
+
+  // Damage of the frames dropped since the last delivered frame.
+  gfx::Rect pending_damage_;
+
+  // Whether a frame was dropped since the last delivered frame.
+  bool frames_dropped_ = false;
+  base::RepeatingClosure frames_dropped_callback_;
+
+  base::WeakPtrFactory<OffscreenFrameRing> weak_factory_{this};
+
+  DISALLOW_COPY_AND_ASSIGN(OffscreenFrameRing);
+};
+
+}  // namespace api
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_API_OFFSCREEN_FRAME_RING_H_
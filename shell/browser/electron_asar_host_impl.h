@@ -0,0 +1,33 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_ELECTRON_ASAR_HOST_IMPL_H_
+#define SHELL_BROWSER_ELECTRON_ASAR_HOST_IMPL_H_
+
+#include "electron/shell/common/api/api.mojom.h"
+#include "mojo/public/cpp/bindings/pending_receiver.h"
+
+namespace electron {
+
+// Hands the indexes of the asar archives opened by the browser process to
+// renderers. Requests are served on the thread pool, so renderers blocked on
+// the sync call never wait for the UI thread.
+class ElectronAsarHostImpl : public mojom::ElectronAsarHost {
+ public:
+  ElectronAsarHostImpl();
+  ~ElectronAsarHostImpl() override;
+
+  ElectronAsarHostImpl(const ElectronAsarHostImpl&) = delete;
+  ElectronAsarHostImpl& operator=(const ElectronAsarHostImpl&) = delete;
+
+  static void Create(mojo::PendingReceiver<mojom::ElectronAsarHost> receiver);
+
+  // mojom::ElectronAsarHost:
+  void GetArchiveIndex(const base::FilePath& path,
+                       GetArchiveIndexCallback callback) override;
+};
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_ELECTRON_ASAR_HOST_IMPL_H_
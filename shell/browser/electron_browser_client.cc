@@ -71,12 +71,14 @@
 #include "shell/browser/api/electron_api_web_request.h"
 #include "shell/browser/badging/badge_manager.h"
 #include "shell/browser/child_web_contents_tracker.h"
+#include "shell/browser/electron_asar_host_impl.h"
 #include "shell/browser/electron_autofill_driver_factory.h"
 #include "shell/browser/electron_browser_context.h"
 #include "shell/browser/electron_browser_handler_impl.h"
 #include "shell/browser/electron_browser_main_parts.h"
 #include "shell/browser/electron_navigation_throttle.h"
 #include "shell/browser/electron_quota_permission_context.h"
+#include "shell/browser/electron_shared_value_host_impl.h"
 #include "shell/browser/electron_speech_recognition_manager_delegate.h"
 #include "shell/browser/font_defaults.h"
 #include "shell/browser/javascript_environment.h"
@@ -550,7 +552,7 @@ void ElectronBrowserClient::AppendExtraCommandLineSwitches(
         switches::kSecureSchemes,        switches::kBypassCSPSchemes,
         switches::kCORSSchemes,          switches::kFetchSchemes,
         switches::kServiceWorkerSchemes, switches::kEnableApiFilteringLogging,
-        switches::kStreamingSchemes};
+        switches::kStreamingSchemes,     switches::kAsarExtractMode};
     command_line->CopySwitchesFrom(*base::CommandLine::ForCurrentProcess(),
                                    kCommonSwitchNames,
                                    base::size(kCommonSwitchNames));
@@ -1429,6 +1431,16 @@ bool ElectronBrowserClient::ShouldEnableStrictSiteIsolation() {
 void ElectronBrowserClient::BindHostReceiverForRenderer(
     content::RenderProcessHost* render_process_host,
     mojo::GenericPendingReceiver receiver) {
+  if (auto host_receiver = receiver.As<electron::mojom::ElectronAsarHost>()) {
+    ElectronAsarHostImpl::Create(std::move(host_receiver));
+    return;
+  }
+  if (auto host_receiver =
+          receiver.As<electron::mojom::ElectronSharedValueHost>()) {
+    ElectronSharedValueHostImpl::Create(
+        render_process_host->GetBrowserContext(), std::move(host_receiver));
+    return;
+  }
 #if BUILDFLAG(ENABLE_BUILTIN_SPELLCHECKER)
   if (auto host_receiver = receiver.As<spellcheck::mojom::SpellCheckHost>()) {
     SpellCheckHostChromeImpl::Create(render_process_host->GetID(),
@@ -44,6 +44,7 @@
 #include "shell/browser/net/resolve_proxy_helper.h"
 #include "shell/browser/pref_store_delegate.h"
 #include "shell/browser/protocol_registry.h"
+#include "shell/browser/shared_value_store.h"
 #include "shell/browser/special_storage_policy.h"
 #include "shell/browser/ui/inspectable_web_contents.h"
 #include "shell/browser/web_view_manager.h"
@@ -155,6 +156,7 @@ ElectronBrowserContext::~ElectronBrowserContext() {
   BrowserContextDependencyManager::GetInstance()->DestroyBrowserContextServices(
       this);
   ShutdownStoragePartitions();
+  SharedValueStore::GetInstance()->DeleteScope(this);
 
   BrowserThread::DeleteSoon(BrowserThread::IO, FROM_HERE,
                             std::move(resource_context_));
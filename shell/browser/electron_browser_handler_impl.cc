@@ -38,23 +38,29 @@ void ElectronBrowserHandlerImpl::OnConnectionError() {
   delete this;
 }
 
-void ElectronBrowserHandlerImpl::Message(bool internal,
-                                         const std::string& channel,
-                                         blink::CloneableMessage arguments) {
+void ElectronBrowserHandlerImpl::Message(
+    bool internal,
+    const std::string& channel,
+    blink::CloneableMessage arguments,
+    mojom::SharedMessagePayloadPtr shared_arguments) {
   api::WebContents* api_web_contents = api::WebContents::From(web_contents());
   if (api_web_contents) {
     api_web_contents->Message(internal, channel, std::move(arguments),
+                              std::move(shared_arguments),
                               GetRenderFrameHost());
   }
 }
-void ElectronBrowserHandlerImpl::Invoke(bool internal,
-                                        const std::string& channel,
-                                        blink::CloneableMessage arguments,
-                                        InvokeCallback callback) {
+void ElectronBrowserHandlerImpl::Invoke(
+    bool internal,
+    const std::string& channel,
+    blink::CloneableMessage arguments,
+    mojom::SharedMessagePayloadPtr shared_arguments,
+    InvokeCallback callback) {
   api::WebContents* api_web_contents = api::WebContents::From(web_contents());
   if (api_web_contents) {
     api_web_contents->Invoke(internal, channel, std::move(arguments),
-                             std::move(callback), GetRenderFrameHost());
+                             std::move(shared_arguments), std::move(callback),
+                             GetRenderFrameHost());
   }
 }
 
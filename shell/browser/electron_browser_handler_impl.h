@@ -32,10 +32,12 @@ class ElectronBrowserHandlerImpl : public mojom::ElectronBrowser,
   // mojom::ElectronBrowser:
   void Message(bool internal,
                const std::string& channel,
-               blink::CloneableMessage arguments) override;
+               blink::CloneableMessage arguments,
+               mojom::SharedMessagePayloadPtr shared_arguments) override;
   void Invoke(bool internal,
               const std::string& channel,
               blink::CloneableMessage arguments,
+              mojom::SharedMessagePayloadPtr shared_arguments,
               InvokeCallback callback) override;
   void OnFirstNonEmptyLayout() override;
   void ReceivePostMessage(const std::string& channel,
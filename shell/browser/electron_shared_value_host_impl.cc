@@ -0,0 +1,52 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/electron_shared_value_host_impl.h"
+
+#include <memory>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/task/thread_pool.h"
+#include "mojo/public/cpp/bindings/self_owned_receiver.h"
+#include "shell/browser/shared_value_store.h"
+
+namespace electron {
+
+namespace {
+
+void BindOnSequence(
+    const void* scope,
+    mojo::PendingReceiver<mojom::ElectronSharedValueHost> receiver) {
+  mojo::MakeSelfOwnedReceiver(
+      std::make_unique<ElectronSharedValueHostImpl>(scope),
+      std::move(receiver));
+}
+
+}  // namespace
+
+ElectronSharedValueHostImpl::ElectronSharedValueHostImpl(const void* scope)
+    : scope_(scope) {}
+
+ElectronSharedValueHostImpl::~ElectronSharedValueHostImpl() = default;
+
+// static
+void ElectronSharedValueHostImpl::Create(
+    const void* scope,
+    mojo::PendingReceiver<mojom::ElectronSharedValueHost> receiver) {
+  base::ThreadPool::CreateSequencedTaskRunner(
+      {base::TaskPriority::USER_BLOCKING,
+       base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN})
+      ->PostTask(FROM_HERE,
+                 base::BindOnce(&BindOnSequence, scope, std::move(receiver)));
+}
+
+void ElectronSharedValueHostImpl::GetSharedValueRegion(
+    const std::string& key,
+    GetSharedValueRegionCallback callback) {
+  std::move(callback).Run(
+      SharedValueStore::GetInstance()->GetRegion(scope_, key));
+}
+
+}  // namespace electron
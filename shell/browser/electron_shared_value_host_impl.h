@@ -0,0 +1,43 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_ELECTRON_SHARED_VALUE_HOST_IMPL_H_
+#define SHELL_BROWSER_ELECTRON_SHARED_VALUE_HOST_IMPL_H_
+
+#include <string>
+
+#include "electron/shell/common/api/api.mojom.h"
+#include "mojo/public/cpp/bindings/pending_receiver.h"
+
+namespace electron {
+
+// Hands the regions of the values published with ipcMain.setSharedValue() to
+// renderers. Like ElectronAsarHostImpl, requests are served on the thread pool
+// so that a busy main process never holds up a renderer's read.
+class ElectronSharedValueHostImpl : public mojom::ElectronSharedValueHost {
+ public:
+  // |scope| is the browser context of the renderer process, which is only
+  // used to look up the values scoped to it.
+  explicit ElectronSharedValueHostImpl(const void* scope);
+  ~ElectronSharedValueHostImpl() override;
+
+  ElectronSharedValueHostImpl(const ElectronSharedValueHostImpl&) = delete;
+  ElectronSharedValueHostImpl& operator=(const ElectronSharedValueHostImpl&) =
+      delete;
+
+  static void Create(
+      const void* scope,
+      mojo::PendingReceiver<mojom::ElectronSharedValueHost> receiver);
+
+  // mojom::ElectronSharedValueHost:
+  void GetSharedValueRegion(const std::string& key,
+                            GetSharedValueRegionCallback callback) override;
+
+ private:
+  const void* const scope_;
+};
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_ELECTRON_SHARED_VALUE_HOST_IMPL_H_
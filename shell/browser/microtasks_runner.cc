@@ -5,6 +5,7 @@
 
 #include "shell/browser/microtasks_runner.h"
 
+#include "base/trace_event/trace_event.h"
 #include "shell/browser/electron_browser_main_parts.h"
 #include "shell/browser/javascript_environment.h"
 #include "shell/common/node_includes.h"
@@ -12,12 +13,49 @@
 
 namespace electron {
 
-MicrotasksRunner::MicrotasksRunner(v8::Isolate* isolate) : isolate_(isolate) {}
+namespace {
+
+// Set by V8 whenever script is about to run on the browser isolate, which
+// includes C++ resolving a promise, and by ScheduleCheckpoint().
+bool g_script_entered = false;
+
+void OnBeforeCallEntered(v8::Isolate* isolate) {
+  g_script_entered = true;
+}
+
+}  // namespace
+
+MicrotasksRunner::MicrotasksRunner(v8::Isolate* isolate) : isolate_(isolate) {
+  isolate_->AddBeforeCallEnteredCallback(&OnBeforeCallEntered);
+  // Node.js may have queued work before the first task runs.
+  g_script_entered = true;
+}
+
+MicrotasksRunner::~MicrotasksRunner() {
+  isolate_->RemoveBeforeCallEnteredCallback(&OnBeforeCallEntered);
+}
+
+// static
+void MicrotasksRunner::ScheduleCheckpoint() {
+  g_script_entered = true;
+}
 
 void MicrotasksRunner::WillProcessTask(const base::PendingTask& pending_task,
                                        bool was_blocked_or_low_priority) {}
 
 void MicrotasksRunner::DidProcessTask(const base::PendingTask& pending_task) {
+  if (!g_script_entered) {
+    ++checkpoints_skipped_;
+    TRACE_COUNTER2("electron", "MicrotasksRunner", "performed",
+                   checkpoints_performed_, "skipped", checkpoints_skipped_);
+    return;
+  }
+
+  TRACE_EVENT0("electron", "MicrotasksRunner::DidProcessTask");
+  ++checkpoints_performed_;
+  TRACE_COUNTER2("electron", "MicrotasksRunner", "performed",
+                 checkpoints_performed_, "skipped", checkpoints_skipped_);
+
   v8::Isolate::Scope scope(isolate_);
   // In the browser process we follow Node.js microtask policy of kExplicit
   // and let the MicrotaskRunner which is a task observer for chromium UI thread
@@ -30,9 +68,14 @@ void MicrotasksRunner::DidProcessTask(const base::PendingTask& pending_task) {
   // handle the checkpoint in the browser process.
   {
     v8::HandleScope scope(isolate_);
-    node::CallbackScope microtasks_scope(isolate_, v8::Object::New(isolate_),
+    if (resource_.IsEmpty())
+      resource_.Reset(isolate_, v8::Object::New(isolate_));
+    node::CallbackScope microtasks_scope(isolate_, resource_.Get(isolate_),
                                          {0, 0});
   }
+
+  // The checkpoint itself runs script, and drains everything it queues.
+  g_script_entered = false;
 }
 
 }  // namespace electron
@@ -6,10 +6,7 @@
 #define SHELL_BROWSER_MICROTASKS_RUNNER_H_
 
 #include "base/task/task_observer.h"
-
-namespace v8 {
-class Isolate;
-}
+#include "v8/include/v8.h"
 
 namespace electron {
 
@@ -19,9 +16,18 @@ namespace electron {
 // Node follows the kExplicit MicrotasksPolicy, and we do the same in browser
 // process. Hence, we need to have this task observer to flush the queued
 // microtasks.
+// The checkpoint is skipped after tasks that neither entered script nor ran
+// the uv loop. V8 also queues microtasks from its own foreground tasks, like
+// the completion of WebAssembly.compile() or FinalizationRegistry cleanup,
+// but those are posted to Node's platform and run from the uv loop.
 class MicrotasksRunner : public base::TaskObserver {
  public:
   explicit MicrotasksRunner(v8::Isolate* isolate);
+  ~MicrotasksRunner() override;
+
+  // Makes the checkpoint run after the current task, for work that may have
+  // queued microtasks without entering script.
+  static void ScheduleCheckpoint();
 
   // base::TaskObserver
   void WillProcessTask(const base::PendingTask& pending_task,
@@ -30,6 +36,13 @@ class MicrotasksRunner : public base::TaskObserver {
 
  private:
   v8::Isolate* isolate_;
+
+  // Resource object for the node::CallbackScope, reused across checkpoints.
+  v8::Global<v8::Object> resource_;
+
+  // Reported through the "electron" tracing category.
+  uint64_t checkpoints_performed_ = 0;
+  uint64_t checkpoints_skipped_ = 0;
 };
 
 }  // namespace electron
@@ -4,6 +4,8 @@
 
 #include "shell/browser/net/asar/asar_url_loader.h"
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
 #include <string>
 #include <utility>
@@ -12,7 +14,9 @@
 #include "base/strings/stringprintf.h"
 #include "base/task/post_task.h"
 #include "base/task/thread_pool.h"
+#include "base/trace_event/trace_event.h"
 #include "content/public/browser/file_url_loader.h"
+#include "crypto/sha2.h"
 #include "mojo/public/cpp/bindings/receiver.h"
 #include "mojo/public/cpp/bindings/remote.h"
 #include "mojo/public/cpp/system/data_pipe_producer.h"
@@ -42,6 +46,8 @@ net::Error ConvertMojoResultToNetError(MojoResult result) {
       return net::ERR_INSUFFICIENT_RESOURCES;
     case MOJO_RESULT_ABORTED:
       return net::ERR_ABORTED;
+    case MOJO_RESULT_DATA_LOSS:
+      return net::ERR_CONTENT_DECODING_FAILED;
     default:
       return net::ERR_FAILED;
   }
@@ -49,11 +55,129 @@ net::Error ConvertMojoResultToNetError(MojoResult result) {
 
 constexpr size_t kDefaultFileUrlPipeSize = 65536;
 
+// Larger files get larger pipes, up to these sizes. Media is read in long
+// sequential runs and benefits from more room.
+constexpr size_t kMaxFileUrlPipeSize = 1024 * 1024;
+constexpr size_t kMaxMediaPipeSize = 4 * 1024 * 1024;
+
 // Because this makes things simpler.
 static_assert(kDefaultFileUrlPipeSize >= net::kMaxBytesToSniff,
               "Default file data pipe size must be at least as large as a MIME-"
               "type sniffing buffer.");
 
+uint32_t GetPipeSize(network::mojom::RequestDestination destination,
+                     uint64_t bytes_to_send) {
+  const bool is_media =
+      destination == network::mojom::RequestDestination::kAudio ||
+      destination == network::mojom::RequestDestination::kVideo ||
+      destination == network::mojom::RequestDestination::kTrack;
+  const size_t max_size = is_media ? kMaxMediaPipeSize : kMaxFileUrlPipeSize;
+  size_t size = kDefaultFileUrlPipeSize;
+  while (size < bytes_to_send && size < max_size)
+    size *= 2;
+  return size;
+}
+
+// Streams the range [start, start + length) of a packed file out of the
+// archive, which takes care of decompressing it if needed.
+//
+// When the header has integrity hashes for the file, every block is read and
+// verified as a whole before any of its bytes go into the pipe, and the read
+// fails at the first block that does not match.
+class ArchiveDataSource : public mojo::DataPipeProducer::DataSource {
+ public:
+  ArchiveDataSource(std::shared_ptr<Archive> archive,
+                    const Archive::FileInfo& info,
+                    uint64_t start,
+                    uint64_t length)
+      : archive_(std::move(archive)),
+        info_(info),
+        start_(start),
+        length_(length) {}
+  ~ArchiveDataSource() override = default;
+
+  ArchiveDataSource(const ArchiveDataSource&) = delete;
+  ArchiveDataSource& operator=(const ArchiveDataSource&) = delete;
+
+  // mojo::DataPipeProducer::DataSource:
+  uint64_t GetLength() const override { return length_; }
+  ReadResult Read(uint64_t offset, base::span<char> buffer) override {
+    ReadResult result;
+    if (offset > length_) {
+      result.result = MOJO_RESULT_OUT_OF_RANGE;
+      return result;
+    }
+
+    size_t size = std::min<uint64_t>(buffer.size(), length_ - offset);
+    auto data =
+        base::make_span(reinterpret_cast<uint8_t*>(buffer.data()), size);
+    const bool ok = info_.integrity_block_size
+                        ? ReadVerified(start_ + offset, data)
+                        : archive_->ReadFile(info_, start_ + offset, data);
+    if (ok)
+      result.bytes_read = size;
+    else
+      result.result = MOJO_RESULT_DATA_LOSS;
+    return result;
+  }
+
+ private:
+  // Copies the bytes at |position| in the file out of their integrity blocks.
+  bool ReadVerified(uint64_t position, base::span<uint8_t> data) {
+    const uint64_t block_size = info_.integrity_block_size;
+    while (!data.empty()) {
+      const size_t block = position / block_size;
+      if ((block != block_index_ || block_.empty()) && !LoadBlock(block))
+        return false;
+      const uint64_t block_start = static_cast<uint64_t>(block) * block_size;
+      const size_t size = std::min<uint64_t>(
+          data.size(), block_start + block_.size() - position);
+      memcpy(data.data(), block_.data() + (position - block_start), size);
+      position += size;
+      data = data.subspan(size);
+    }
+    return true;
+  }
+
+  // Reads |block| into |block_| and checks it against its hash.
+  bool LoadBlock(size_t block) {
+    const uint64_t block_start =
+        static_cast<uint64_t>(block) * info_.integrity_block_size;
+    block_.resize(std::min<uint64_t>(info_.integrity_block_size,
+                                     info_.size - block_start));
+    block_index_ = block;
+    if (!archive_->ReadFile(info_, block_start, block_)) {
+      block_.clear();
+      return false;
+    }
+
+    uint8_t actual[ArchiveIndex::kHashSize];
+    crypto::SHA256HashString(
+        base::StringPiece(reinterpret_cast<const char*>(block_.data()),
+                          block_.size()),
+        actual, sizeof(actual));
+    base::span<const uint8_t> expected = info_.integrity_hashes.subspan(
+        block * ArchiveIndex::kHashSize, ArchiveIndex::kHashSize);
+    if (memcmp(actual, expected.data(), sizeof(actual)) != 0) {
+      LOG(ERROR) << "Integrity check failed for block " << block << " of a "
+                 << "file in " << archive_->path().value();
+      block_.clear();
+      return false;
+    }
+    return true;
+  }
+
+  // Keeps the mapping and the index |info_| points into alive.
+  std::shared_ptr<Archive> archive_;
+  const Archive::FileInfo info_;
+  const uint64_t start_;
+  const uint64_t length_;
+
+  // The verified integrity block the last read ended in.
+  std::vector<uint8_t> block_;
+  size_t block_index_ = 0;
+};
+
 // Modified from the |FileURLLoader| in |file_url_loader_factory.cc|, to serve
 // asar files instead of normal files.
 class AsarURLLoader : public network::mojom::URLLoader {
@@ -84,12 +208,20 @@ class AsarURLLoader : public network::mojom::URLLoader {
 
  private:
   AsarURLLoader() = default;
-  ~AsarURLLoader() override = default;
+  ~AsarURLLoader() override {
+    TRACE_EVENT_NESTABLE_ASYNC_END1("electron", "AsarURLLoader",
+                                    TRACE_ID_LOCAL(this), "bytes",
+                                    total_bytes_written_);
+  }
 
   void Start(const network::ResourceRequest& request,
              mojo::PendingReceiver<network::mojom::URLLoader> loader,
              mojo::PendingRemote<network::mojom::URLLoaderClient> client,
              scoped_refptr<net::HttpResponseHeaders> extra_response_headers) {
+    TRACE_EVENT_NESTABLE_ASYNC_BEGIN1("electron", "AsarURLLoader",
+                                      TRACE_ID_LOCAL(this), "url",
+                                      request.url.possibly_invalid_spec());
+    TRACE_EVENT0("electron", "AsarURLLoader::Start");
     auto head = network::mojom::URLResponseHead::New();
     head->request_start = base::TimeTicks::Now();
     head->response_start = base::TimeTicks::Now();
@@ -130,35 +262,8 @@ class AsarURLLoader : public network::mojom::URLLoader {
 
     // For unpacked path, read like normal file.
     base::FilePath real_path;
-    if (info.unpacked) {
+    if (info.unpacked)
       archive->CopyFileOut(relative_path, &real_path);
-      info.offset = 0;
-    }
-
-    mojo::ScopedDataPipeProducerHandle producer_handle;
-    mojo::ScopedDataPipeConsumerHandle consumer_handle;
-    if (mojo::CreateDataPipe(kDefaultFileUrlPipeSize, producer_handle,
-                             consumer_handle) != MOJO_RESULT_OK) {
-      OnClientComplete(net::ERR_FAILED);
-      return;
-    }
-
-    // Note that while the |Archive| already opens a |base::File|, we still need
-    // to create a new |base::File| here, as it might be accessed by multiple
-    // requests at the same time.
-    base::File file(info.unpacked ? real_path : archive->path(),
-                    base::File::FLAG_OPEN | base::File::FLAG_READ);
-    auto file_data_source =
-        std::make_unique<mojo::FileDataSource>(std::move(file));
-    mojo::DataPipeProducer::DataSource* data_source = file_data_source.get();
-
-    std::vector<char> initial_read_buffer(net::kMaxBytesToSniff);
-    auto read_result =
-        data_source->Read(info.offset, base::span<char>(initial_read_buffer));
-    if (read_result.result != MOJO_RESULT_OK) {
-      OnClientComplete(ConvertMojoResultToNetError(read_result.result));
-      return;
-    }
 
     std::string range_header;
     net::HttpByteRange byte_range;
@@ -191,20 +296,80 @@ class AsarURLLoader : public network::mojom::URLLoader {
           byte_range.last_byte_position() - first_byte_to_send + 1;
     }
 
-    total_bytes_written_ = total_bytes_to_send;
-
     head->content_length = base::saturated_cast<int64_t>(total_bytes_to_send);
 
-    if (first_byte_to_send < read_result.bytes_read) {
+    // Get the disk going on the whole range before the first read.
+    if (!info.unpacked)
+      archive->WillRead(info, first_byte_to_send, total_bytes_to_send);
+
+    mojo::ScopedDataPipeProducerHandle producer_handle;
+    mojo::ScopedDataPipeConsumerHandle consumer_handle;
+    if (mojo::CreateDataPipe(
+            GetPipeSize(request.destination, total_bytes_to_send),
+            producer_handle, consumer_handle) != MOJO_RESULT_OK) {
+      OnClientComplete(net::ERR_FAILED);
+      return;
+    }
+
+    // Packed files are served by the archive. Unpacked files are read like
+    // normal files.
+    std::unique_ptr<mojo::FileDataSource> file_data_source;
+    if (info.unpacked) {
+      base::File file(real_path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+      file_data_source =
+          std::make_unique<mojo::FileDataSource>(std::move(file));
+    }
+
+    // Only read the beginning of the file when its extension does not tell
+    // its type, which spares a read far from the requested range for media.
+    // Uncompressed packed files are sniffed straight from the mapping.
+    const bool needs_sniffing =
+        !net::GetMimeTypeFromFile(path, &head->mime_type);
+    base::span<const uint8_t> contents;
+    std::vector<char> initial_read_buffer;
+    base::StringPiece initial_read;
+    if (needs_sniffing) {
+      if (archive->GetFileContents(info, &contents)) {
+        initial_read = base::StringPiece(
+            reinterpret_cast<const char*>(contents.data()),
+            std::min<size_t>(contents.size(), net::kMaxBytesToSniff));
+      } else if (file_data_source) {
+        initial_read_buffer.resize(net::kMaxBytesToSniff);
+        auto read_result = file_data_source->Read(
+            0, base::span<char>(initial_read_buffer));
+        if (read_result.result != MOJO_RESULT_OK) {
+          OnClientComplete(ConvertMojoResultToNetError(read_result.result));
+          return;
+        }
+        initial_read = base::StringPiece(initial_read_buffer.data(),
+                                         read_result.bytes_read);
+      } else {
+        initial_read_buffer.resize(
+            std::min<size_t>(info.size, net::kMaxBytesToSniff));
+        if (!archive->ReadFile(info, 0,
+                               base::as_writable_bytes(
+                                   base::make_span(initial_read_buffer)))) {
+          OnClientComplete(net::ERR_FAILED);
+          return;
+        }
+        initial_read = base::StringPiece(initial_read_buffer.data(),
+                                         initial_read_buffer.size());
+      }
+    }
+
+    // Files with integrity hashes are only ever sent through the verifying
+    // |ArchiveDataSource|.
+    if (!info.integrity_block_size &&
+        first_byte_to_send < initial_read.size()) {
       // Write any data we read for MIME sniffing, constraining by range where
       // applicable. This will always fit in the pipe (see assertion near
       // |kDefaultFileUrlPipeSize| definition).
       uint32_t write_size = std::min(
-          static_cast<uint32_t>(read_result.bytes_read - first_byte_to_send),
+          static_cast<uint32_t>(initial_read.size() - first_byte_to_send),
           static_cast<uint32_t>(total_bytes_to_send));
       const uint32_t expected_write_size = write_size;
       MojoResult result =
-          producer_handle->WriteData(&initial_read_buffer[first_byte_to_send],
+          producer_handle->WriteData(&initial_read[first_byte_to_send],
                                      &write_size, MOJO_WRITE_DATA_FLAG_NONE);
       if (result != MOJO_RESULT_OK || write_size != expected_write_size) {
         OnFileWritten(result);
@@ -212,16 +377,15 @@ class AsarURLLoader : public network::mojom::URLLoader {
       }
 
       // Discount the bytes we just sent from the total range.
-      first_byte_to_send = read_result.bytes_read;
+      total_bytes_written_ += write_size;
+      first_byte_to_send = initial_read.size();
       total_bytes_to_send -= write_size;
     }
 
-    if (!net::GetMimeTypeFromFile(path, &head->mime_type)) {
+    if (needs_sniffing) {
       std::string new_type;
-      net::SniffMimeType(
-          base::StringPiece(initial_read_buffer.data(), read_result.bytes_read),
-          request.url, head->mime_type,
-          net::ForceSniffFileUrlsForHtml::kDisabled, &new_type);
+      net::SniffMimeType(initial_read, request.url, head->mime_type,
+                         net::ForceSniffFileUrlsForHtml::kDisabled, &new_type);
       head->mime_type.assign(new_type);
       head->did_mime_sniff = true;
     }
@@ -229,6 +393,8 @@ class AsarURLLoader : public network::mojom::URLLoader {
       head->headers->AddHeader(net::HttpRequestHeaders::kContentType,
                                head->mime_type.c_str());
     }
+    TRACE_EVENT_NESTABLE_ASYNC_INSTANT0("electron", "AsarURLLoader::Response",
+                                        TRACE_ID_LOCAL(this));
     client_->OnReceiveResponse(std::move(head));
     client_->OnStartLoadingResponseBody(std::move(consumer_handle));
 
@@ -238,20 +404,25 @@ class AsarURLLoader : public network::mojom::URLLoader {
       return;
     }
 
-    // In case of a range request, seek to the appropriate position before
-    // sending the remaining bytes asynchronously. Under normal conditions
-    // (i.e., no range request) this Seek is effectively a no-op.
-    //
-    // Note that in Electron we also need to add file offset.
-    file_data_source->SetRange(
-        first_byte_to_send + info.offset,
-        first_byte_to_send + info.offset + total_bytes_to_send);
+    std::unique_ptr<mojo::DataPipeProducer::DataSource> data_source;
+    if (file_data_source) {
+      // In case of a range request, seek to the appropriate position before
+      // sending the remaining bytes asynchronously. Under normal conditions
+      // (i.e., no range request) this Seek is effectively a no-op.
+      file_data_source->SetRange(first_byte_to_send,
+                                 first_byte_to_send + total_bytes_to_send);
+      data_source = std::move(file_data_source);
+    } else {
+      data_source = std::make_unique<ArchiveDataSource>(
+          std::move(archive), info, first_byte_to_send, total_bytes_to_send);
+    }
 
     data_producer_ =
         std::make_unique<mojo::DataPipeProducer>(std::move(producer_handle));
     data_producer_->Write(
-        std::move(file_data_source),
-        base::BindOnce(&AsarURLLoader::OnFileWritten, base::Unretained(this)));
+        std::move(data_source),
+        base::BindOnce(&AsarURLLoader::OnDataWritten, base::Unretained(this),
+                       total_bytes_to_send));
   }
 
   void OnConnectionError() {
@@ -270,6 +441,13 @@ class AsarURLLoader : public network::mojom::URLLoader {
       delete this;
   }
 
+  // The producer only succeeds once all |bytes| of its source are written.
+  void OnDataWritten(uint64_t bytes, MojoResult result) {
+    if (result == MOJO_RESULT_OK)
+      total_bytes_written_ += bytes;
+    OnFileWritten(result);
+  }
+
   void OnFileWritten(MojoResult result) {
     // All the data has been written now. Close the data pipe. The consumer will
     // be notified that there will be no more data to read from now.
@@ -282,7 +460,8 @@ class AsarURLLoader : public network::mojom::URLLoader {
       status.decoded_body_length = total_bytes_written_;
       client_->OnComplete(status);
     } else {
-      client_->OnComplete(network::URLLoaderCompletionStatus(net::ERR_FAILED));
+      client_->OnComplete(network::URLLoaderCompletionStatus(
+          ConvertMojoResultToNetError(result)));
     }
     client_.reset();
     MaybeDeleteSelf();
@@ -292,9 +471,8 @@ class AsarURLLoader : public network::mojom::URLLoader {
   mojo::Receiver<network::mojom::URLLoader> receiver_{this};
   mojo::Remote<network::mojom::URLLoaderClient> client_;
 
-  // In case of successful loads, this holds the total number of bytes written
-  // to the response (this may be smaller than the total size of the file when
-  // a byte range was requested).
+  // The number of bytes written to the response so far. In case of successful
+  // loads, this is the size of the requested range.
   // It is used to set some of the URLLoaderCompletionStatus data passed back
   // to the URLLoaderClients (eg SimpleURLLoader).
   size_t total_bytes_written_ = 0;
@@ -33,7 +33,6 @@
 #include "media/base/video_frame.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 #include "third_party/blink/public/common/input/web_input_event.h"
-#include "third_party/skia/include/core/SkCanvas.h"
 #include "ui/compositor/compositor.h"
 #include "ui/compositor/layer.h"
 #include "ui/compositor/layer_type.h"
@@ -46,6 +45,7 @@
 #include "ui/gfx/image/image_skia.h"
 #include "ui/gfx/native_widget_types.h"
 #include "ui/gfx/skbitmap_operations.h"
+#include "ui/gfx/skia_util.h"
 #include "ui/latency/latency_info.h"
 
 namespace electron {
@@ -668,17 +668,42 @@ bool OffScreenRenderWidgetHostView::UpdateNSViewAndDisplay() {
 
 void OffScreenRenderWidgetHostView::OnPaint(const gfx::Rect& damage_rect,
                                             const SkBitmap& bitmap) {
-  backing_ = std::make_unique<SkBitmap>();
-  backing_->allocN32Pixels(bitmap.width(), bitmap.height(), !transparent_);
-  bitmap.readPixels(backing_->pixmap());
+  if (share_captured_pixels_) {
+    // The capturer's shared memory stays pinned until |backing_| is replaced
+    // by the next frame.
+    backing_ = std::make_unique<SkBitmap>(bitmap);
+    if (!transparent_)
+      backing_->setAlphaType(kOpaque_SkAlphaType);
+  } else {
+    backing_ = std::make_unique<SkBitmap>();
+    backing_->allocN32Pixels(bitmap.width(), bitmap.height(), !transparent_);
+    bitmap.readPixels(backing_->pixmap());
+  }
 
   if (IsPopupWidget() && parent_callback_) {
-    parent_callback_.Run(this->popup_position_);
+    // Only the damaged part of the popup has to be composited again.
+    gfx::Rect damage_in_dip = gfx::ToEnclosingRect(
+        gfx::ConvertRectToDips(damage_rect, GetCurrentDeviceScaleFactor()));
+    damage_in_dip.Offset(popup_position_.OffsetFromOrigin());
+    parent_callback_.Run(gfx::IntersectRects(popup_position_, damage_in_dip));
   } else {
     CompositeFrame(damage_rect);
   }
 }
 
+void OffScreenRenderWidgetHostView::SetShareCapturedPixels(bool share) {
+  if (share_captured_pixels_ && !share && !backing_->drawsNothing()) {
+    // The current frame can be composited again without a new paint, so stop
+    // referencing the captured memory before it can reach a NativeImage.
+    auto backing = std::make_unique<SkBitmap>();
+    backing->allocN32Pixels(backing_->width(), backing_->height(),
+                            !transparent_);
+    backing_->readPixels(backing->pixmap());
+    backing_ = std::move(backing);
+  }
+  share_captured_pixels_ = share;
+}
+
 gfx::Size OffScreenRenderWidgetHostView::SizeInPixels() {
   float sf = GetCurrentDeviceScaleFactor();
   if (IsPopupWidget()) {
@@ -695,46 +720,107 @@ void OffScreenRenderWidgetHostView::CompositeFrame(
   HoldResize();
 
   gfx::Size size_in_pixels = SizeInPixels();
+  gfx::Rect frame_rect(size_in_pixels);
+  gfx::Rect damage = gfx::IntersectRects(frame_rect, damage_rect);
 
   SkBitmap frame;
 
   // Optimize for the case when there is no popup
   if (proxy_views_.empty() && !popup_host_view_) {
     frame = GetBacking();
+    // Whatever the layers covered in the last composited frame is now
+    // showing the backing again.
+    for (const auto& rect : composited_layer_rects_)
+      damage.Union(gfx::IntersectRects(frame_rect, rect));
+    composited_layer_rects_.clear();
+    composite_.reset();
   } else {
     float sf = GetCurrentDeviceScaleFactor();
-    frame.allocN32Pixels(size_in_pixels.width(), size_in_pixels.height(),
-                         false);
-    if (!GetBacking().drawsNothing()) {
-      SkCanvas canvas(frame);
-      canvas.writePixels(GetBacking(), 0, 0);
-
-      if (popup_host_view_ && !popup_host_view_->GetBacking().drawsNothing()) {
-        gfx::Rect rect = popup_host_view_->popup_position_;
-        gfx::Point origin_in_pixels =
-            gfx::ToFlooredPoint(gfx::ConvertPointToPixels(rect.origin(), sf));
-        canvas.writePixels(popup_host_view_->GetBacking(), origin_in_pixels.x(),
-                           origin_in_pixels.y());
-      }
 
-      for (auto* proxy_view : proxy_views_) {
-        gfx::Rect rect = proxy_view->GetBounds();
-        gfx::Point origin_in_pixels =
-            gfx::ToFlooredPoint(gfx::ConvertPointToPixels(rect.origin(), sf));
-        canvas.writePixels(*proxy_view->GetBitmap(), origin_in_pixels.x(),
-                           origin_in_pixels.y());
+    std::vector<gfx::Rect> layer_rects;
+    std::vector<const SkBitmap*> layer_bitmaps;
+    if (popup_host_view_ && !popup_host_view_->GetBacking().drawsNothing()) {
+      const SkBitmap& bitmap = popup_host_view_->GetBacking();
+      gfx::Point origin_in_pixels =
+          gfx::ToFlooredPoint(gfx::ConvertPointToPixels(
+              popup_host_view_->popup_position_.origin(), sf));
+      layer_rects.emplace_back(origin_in_pixels,
+                               gfx::Size(bitmap.width(), bitmap.height()));
+      layer_bitmaps.push_back(&bitmap);
+    }
+    for (auto* proxy_view : proxy_views_) {
+      const SkBitmap* bitmap = proxy_view->GetBitmap();
+      gfx::Point origin_in_pixels = gfx::ToFlooredPoint(
+          gfx::ConvertPointToPixels(proxy_view->GetBounds().origin(), sf));
+      layer_rects.emplace_back(origin_in_pixels,
+                               gfx::Size(bitmap->width(), bitmap->height()));
+      layer_bitmaps.push_back(bitmap);
+    }
+
+    // Layers that appeared, moved or went away damage both their old and
+    // their new position.
+    if (layer_rects != composited_layer_rects_) {
+      for (const auto& rect : composited_layer_rects_)
+        damage.Union(gfx::IntersectRects(frame_rect, rect));
+      for (const auto& rect : layer_rects)
+        damage.Union(gfx::IntersectRects(frame_rect, rect));
+      composited_layer_rects_ = std::move(layer_rects);
+    }
+
+    // Only the damaged area is composited again, unless the surface has to
+    // be rebuilt from scratch.
+    gfx::Rect redraw_rect = damage;
+    if (composite_.drawsNothing() ||
+        composite_.width() != size_in_pixels.width() ||
+        composite_.height() != size_in_pixels.height()) {
+      composite_.allocN32Pixels(size_in_pixels.width(),
+                                size_in_pixels.height(), false);
+      composite_.eraseColor(SK_ColorTRANSPARENT);
+      redraw_rect = frame_rect;
+    } else if (!composite_.pixelRef()->unique()) {
+      // A previous frame is still referenced by the paint callback's
+      // consumer (e.g. a NativeImage), so it must not change under it.
+      SkBitmap surface;
+      surface.allocN32Pixels(size_in_pixels.width(), size_in_pixels.height(),
+                             false);
+      composite_.readPixels(surface.pixmap());
+      composite_ = surface;
+    }
+
+    if (!GetBacking().drawsNothing() && !redraw_rect.IsEmpty()) {
+      WriteLayerPixels(GetBacking(), gfx::Point(), redraw_rect);
+      for (size_t i = 0; i < layer_bitmaps.size(); ++i) {
+        WriteLayerPixels(*layer_bitmaps[i],
+                         composited_layer_rects_[i].origin(), redraw_rect);
       }
     }
+
+    frame = composite_;
   }
 
   paint_callback_running_ = true;
-  callback_.Run(gfx::IntersectRects(gfx::Rect(size_in_pixels), damage_rect),
-                frame);
+  callback_.Run(damage, frame);
   paint_callback_running_ = false;
 
   ReleaseResize();
 }
 
+void OffScreenRenderWidgetHostView::WriteLayerPixels(
+    const SkBitmap& layer,
+    const gfx::Point& origin,
+    const gfx::Rect& clip_rect) {
+  gfx::Rect rect = gfx::IntersectRects(
+      clip_rect, gfx::Rect(origin, gfx::Size(layer.width(), layer.height())));
+  SkPixmap pixmap;
+  if (rect.IsEmpty() || !layer.peekPixels(&pixmap))
+    return;
+
+  SkPixmap subset;
+  gfx::Rect rect_in_layer = rect - origin.OffsetFromOrigin();
+  if (pixmap.extractSubset(&subset, gfx::RectToSkIRect(rect_in_layer)))
+    composite_.writePixels(subset, rect.x(), rect.y());
+}
+
 void OffScreenRenderWidgetHostView::OnPopupPaint(const gfx::Rect& damage_rect) {
   InvalidateBounds(gfx::ToEnclosingRect(
       gfx::ConvertRectToPixels(damage_rect, GetCurrentDeviceScaleFactor())));
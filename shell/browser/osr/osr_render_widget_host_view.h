@@ -176,6 +176,11 @@ class OffScreenRenderWidgetHostView : public content::RenderWidgetHostViewBase,
   gfx::Size SizeInPixels();
 
   void CompositeFrame(const gfx::Rect& damage_rect);
+  // Copies the part of |layer|, placed at |origin|, that lies inside
+  // |clip_rect| into |composite_|.
+  void WriteLayerPixels(const SkBitmap& layer,
+                        const gfx::Point& origin,
+                        const gfx::Rect& clip_rect);
 
   bool IsPopupWidget() const {
     return widget_type_ == content::WidgetType::kPopup;
@@ -196,6 +201,11 @@ class OffScreenRenderWidgetHostView : public content::RenderWidgetHostViewBase,
   void SetFrameRate(int frame_rate);
   int GetFrameRate() const;
 
+  // When set, painted frames keep the captured pixels instead of copying
+  // them.  The captured memory is read-only, so this is only safe while no
+  // NativeImage is created from the painted frames.
+  void SetShareCapturedPixels(bool share);
+
   ui::Compositor* GetCompositor() const;
   ui::Layer* GetRootLayer() const;
 
@@ -258,6 +268,7 @@ class OffScreenRenderWidgetHostView : public content::RenderWidgetHostViewBase,
   bool pending_resize_ = false;
 
   bool paint_callback_running_ = false;
+  bool share_captured_pixels_ = false;
 
   viz::LocalSurfaceId delegated_frame_host_surface_id_;
   viz::ParentLocalSurfaceIdAllocator delegated_frame_host_allocator_;
@@ -288,6 +299,12 @@ class OffScreenRenderWidgetHostView : public content::RenderWidgetHostViewBase,
 
   std::unique_ptr<SkBitmap> backing_;
 
+  // Frame that the popup and proxy views are composited into.  It is kept
+  // between paints so only damaged areas have to be written again.
+  SkBitmap composite_;
+  // Where each layer was placed in |composite_|, in pixels.
+  std::vector<gfx::Rect> composited_layer_rects_;
+
   base::WeakPtrFactory<OffScreenRenderWidgetHostView> weak_ptr_factory_{this};
 
   DISALLOW_COPY_AND_ASSIGN(OffScreenRenderWidgetHostView);
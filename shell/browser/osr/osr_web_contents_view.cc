@@ -118,9 +118,11 @@ OffScreenWebContentsView::CreateViewForWidget(
         render_widget_host->GetView());
   }
 
-  return new OffScreenRenderWidgetHostView(
+  auto* view = new OffScreenRenderWidgetHostView(
       transparent_, painting_, GetFrameRate(), callback_, render_widget_host,
       nullptr, GetSize());
+  view->SetShareCapturedPixels(share_captured_pixels_);
+  return view;
 }
 
 content::RenderWidgetHostViewBase*
@@ -134,9 +136,11 @@ OffScreenWebContentsView::CreateViewForChildWidget(
           ? web_contents_impl->GetOuterWebContents()->GetRenderWidgetHostView()
           : web_contents_impl->GetRenderWidgetHostView());
 
-  return new OffScreenRenderWidgetHostView(transparent_, painting_,
-                                           view->GetFrameRate(), callback_,
-                                           render_widget_host, view, GetSize());
+  auto* child_view = new OffScreenRenderWidgetHostView(
+      transparent_, painting_, view->GetFrameRate(), callback_,
+      render_widget_host, view, GetSize());
+  child_view->SetShareCapturedPixels(share_captured_pixels_);
+  return child_view;
 }
 
 void OffScreenWebContentsView::SetPageTitle(const std::u16string& title) {}
@@ -207,6 +211,14 @@ int OffScreenWebContentsView::GetFrameRate() const {
   }
 }
 
+void OffScreenWebContentsView::SetShareCapturedPixels(bool share) {
+  auto* view = GetView();
+  share_captured_pixels_ = share;
+  if (view != nullptr) {
+    view->SetShareCapturedPixels(share);
+  }
+}
+
 OffScreenRenderWidgetHostView* OffScreenWebContentsView::GetView() const {
   if (web_contents_) {
     return static_cast<OffScreenRenderWidgetHostView*>(
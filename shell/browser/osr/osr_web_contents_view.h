@@ -79,6 +79,7 @@ class OffScreenWebContentsView : public content::WebContentsView,
   bool IsPainting() const;
   void SetFrameRate(int frame_rate);
   int GetFrameRate() const;
+  void SetShareCapturedPixels(bool share);
 
  private:
 #if defined(OS_MAC)
@@ -93,6 +94,7 @@ class OffScreenWebContentsView : public content::WebContentsView,
   const bool transparent_;
   bool painting_ = true;
   int frame_rate_ = 60;
+  bool share_captured_pixels_ = false;
   OnPaintCallback callback_;
 
   // Weak refs.
@@ -0,0 +1,96 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/shared_value_store.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/check.h"
+
+#include "shell/common/shared_value.h"
+
+namespace electron {
+
+namespace {
+
+// Leave room for the value to grow, so that most updates are written in
+// place and renderers keep reading from the region they already have.
+constexpr size_t kMinCapacity = 4096;
+
+}  // namespace
+
+// static
+SharedValueStore* SharedValueStore::GetInstance() {
+  static base::NoDestructor<SharedValueStore> instance;
+  return instance.get();
+}
+
+SharedValueStore::Value::Value() = default;
+SharedValueStore::Value::Value(Value&&) = default;
+SharedValueStore::Value& SharedValueStore::Value::operator=(Value&&) = default;
+SharedValueStore::Value::~Value() = default;
+
+SharedValueStore::SharedValueStore() = default;
+
+SharedValueStore::~SharedValueStore() = default;
+
+bool SharedValueStore::Set(const void* scope,
+                           const std::string& key,
+                           base::span<const uint8_t> data) {
+  base::AutoLock auto_lock(lock_);
+  Value& value = values_[key];
+  if (value.writer && value.scope == scope && value.writer->Write(data))
+    return true;
+
+  auto new_writer =
+      SharedValueWriter::Create(std::max(kMinCapacity, data.size() * 2));
+  if (!new_writer || !new_writer->Write(data)) {
+    if (!value.writer)
+      values_.erase(key);
+    return false;
+  }
+  // Renderers that read the old value ask again, and only get the new one if
+  // they may.
+  if (value.writer)
+    value.writer->MarkReplaced();
+  value.scope = scope;
+  value.writer = std::move(new_writer);
+  return true;
+}
+
+void SharedValueStore::Delete(const std::string& key) {
+  base::AutoLock auto_lock(lock_);
+  auto it = values_.find(key);
+  if (it == values_.end())
+    return;
+  it->second.writer->MarkReplaced();
+  values_.erase(it);
+}
+
+void SharedValueStore::DeleteScope(const void* scope) {
+  DCHECK(scope);
+  base::AutoLock auto_lock(lock_);
+  for (auto it = values_.begin(); it != values_.end();) {
+    if (it->second.scope == scope) {
+      it->second.writer->MarkReplaced();
+      it = values_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+base::ReadOnlySharedMemoryRegion SharedValueStore::GetRegion(
+    const void* scope,
+    const std::string& key) {
+  base::AutoLock auto_lock(lock_);
+  auto it = values_.find(key);
+  if (it == values_.end() ||
+      (it->second.scope && it->second.scope != scope))
+    return base::ReadOnlySharedMemoryRegion();
+  return it->second.writer->DuplicateRegion();
+}
+
+}  // namespace electron
@@ -0,0 +1,72 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_SHARED_VALUE_STORE_H_
+#define SHELL_BROWSER_SHARED_VALUE_STORE_H_
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "base/containers/span.h"
+#include "base/memory/read_only_shared_memory_region.h"
+#include "base/no_destructor.h"
+#include "base/synchronization/lock.h"
+
+namespace electron {
+
+class SharedValueWriter;
+
+// The values published with ipcMain.setSharedValue(). Values are written on
+// the UI thread, and their regions are handed to renderers from the thread
+// pool.
+//
+// Each value is either visible to all renderers, or scoped to the renderers
+// of one browser context. Scopes are only compared, never dereferenced.
+class SharedValueStore {
+ public:
+  static SharedValueStore* GetInstance();
+
+  SharedValueStore(const SharedValueStore&) = delete;
+  SharedValueStore& operator=(const SharedValueStore&) = delete;
+
+  // Publishes the serialized value |data| under |key|, for the renderers of
+  // |scope|, or for all of them if |scope| is null. Replaces the value of
+  // |key| in any other scope.
+  bool Set(const void* scope,
+           const std::string& key,
+           base::span<const uint8_t> data);
+  void Delete(const std::string& key);
+
+  // Deletes the values scoped to |scope|.
+  void DeleteScope(const void* scope);
+
+  // Returns an invalid region if there is no value for |key| that renderers
+  // of |scope| may read.
+  base::ReadOnlySharedMemoryRegion GetRegion(const void* scope,
+                                             const std::string& key);
+
+ private:
+  friend class base::NoDestructor<SharedValueStore>;
+
+  struct Value {
+    Value();
+    Value(Value&&);
+    Value& operator=(Value&&);
+    ~Value();
+
+    const void* scope = nullptr;
+    std::unique_ptr<SharedValueWriter> writer;
+  };
+
+  SharedValueStore();
+  ~SharedValueStore();
+
+  base::Lock lock_;
+  std::map<std::string, Value> values_;
+};
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_SHARED_VALUE_STORE_H_
@@ -2,8 +2,13 @@
 // Use of this source code is governed by the MIT license that can be
 // found in the LICENSE file.
 
+#include <memory>
+#include <utility>
 #include <vector>
 
+#include "base/bind.h"
+#include "base/task/thread_pool.h"
+#include "base/threading/sequenced_task_runner_handle.h"
 #include "gin/handle.h"
 #include "gin/object_template_builder.h"
 #include "gin/wrappable.h"
@@ -12,17 +17,74 @@
 #include "shell/common/gin_converters/callback_converter.h"
 #include "shell/common/gin_converters/file_path_converter.h"
 #include "shell/common/gin_helper/dictionary.h"
+#include "shell/common/gin_helper/locker.h"
+#include "shell/common/gin_helper/promise.h"
 #include "shell/common/node_includes.h"
 #include "shell/common/node_util.h"
 
 namespace {
 
+// Values of the first field of each |Archive::StatBatch| result.
+enum class StatKind { kMissing = 0, kFile = 1, kDirectory = 2, kLink = 3 };
+
+// Number of doubles in each |Archive::StatBatch| result.
+constexpr size_t kStatBatchFields = 3;
+
+// Reads the whole content of a packed file, decompressing it if needed.
+// Returns null on failure.
+std::unique_ptr<std::vector<uint8_t>> ReadFileContents(
+    std::shared_ptr<asar::Archive> archive,
+    asar::Archive::FileInfo info) {
+  auto contents = std::make_unique<std::vector<uint8_t>>(info.size);
+  if (!archive->ReadFile(info, 0, *contents))
+    return nullptr;
+  return contents;
+}
+
+void FreeFileContents(char* data, void* hint) {
+  delete static_cast<std::vector<uint8_t>*>(hint);
+}
+
+// Resolves |promise| with a Buffer that takes over |contents|, or with false
+// if reading failed.
+void ResolveWithFileContents(
+    gin_helper::Promise<v8::Local<v8::Value>> promise,
+    std::unique_ptr<std::vector<uint8_t>> contents) {
+  v8::Isolate* isolate = promise.isolate();
+  gin_helper::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  v8::Context::Scope context_scope(promise.GetContext());
+
+  if (!contents) {
+    promise.Resolve(v8::False(isolate));
+    return;
+  }
+
+  v8::Local<v8::Object> buffer;
+  if (contents->empty()) {
+    buffer = node::Buffer::New(isolate, 0).ToLocalChecked();
+  } else {
+    auto* data = reinterpret_cast<char*>(contents->data());
+    size_t size = contents->size();
+    // node frees |contents| through FreeFileContents() even on failure.
+    if (!node::Buffer::New(isolate, data, size, &FreeFileContents,
+                           contents.release())
+             .ToLocal(&buffer)) {
+      promise.RejectWithErrorMessage("Failed to allocate the buffer");
+      return;
+    }
+  }
+  promise.Resolve(buffer);
+}
+
 class Archive : public gin::Wrappable<Archive> {
  public:
   static gin::Handle<Archive> Create(v8::Isolate* isolate,
                                      const base::FilePath& path) {
-    auto archive = std::make_unique<asar::Archive>(path);
-    if (!archive->Init())
+    // Share the archive with the rest of the process, so its header is only
+    // indexed once.
+    std::shared_ptr<asar::Archive> archive = asar::GetOrCreateAsarArchive(path);
+    if (!archive)
       return gin::Handle<Archive>();
     return gin::CreateHandle(isolate, new Archive(isolate, std::move(archive)));
   }
@@ -35,16 +97,19 @@ class Archive : public gin::Wrappable<Archive> {
         .SetProperty("path", &Archive::GetPath)
         .SetMethod("getFileInfo", &Archive::GetFileInfo)
         .SetMethod("stat", &Archive::Stat)
+        .SetMethod("statBatch", &Archive::StatBatch)
         .SetMethod("readdir", &Archive::Readdir)
         .SetMethod("realpath", &Archive::Realpath)
         .SetMethod("copyFileOut", &Archive::CopyFileOut)
+        .SetMethod("read", &Archive::Read)
+        .SetMethod("readAsync", &Archive::ReadAsync)
         .SetMethod("getFd", &Archive::GetFD);
   }
 
   const char* GetTypeName() override { return "Archive"; }
 
  protected:
-  Archive(v8::Isolate* isolate, std::unique_ptr<asar::Archive> archive)
+  Archive(v8::Isolate* isolate, std::shared_ptr<asar::Archive> archive)
       : archive_(std::move(archive)) {}
 
   // Returns the path of the file.
@@ -60,6 +125,7 @@ class Archive : public gin::Wrappable<Archive> {
     dict.Set("size", info.size);
     dict.Set("unpacked", info.unpacked);
     dict.Set("offset", info.offset);
+    dict.Set("compressed", info.compressed);
     return dict.GetHandle();
   }
 
@@ -77,6 +143,33 @@ class Archive : public gin::Wrappable<Archive> {
     return dict.GetHandle();
   }
 
+  // Stats many paths with a single call. Returns a Float64Array holding a
+  // [kind, size, offset] triple per path, where kind is a |StatKind|.
+  v8::Local<v8::Value> StatBatch(v8::Isolate* isolate,
+                                 const std::vector<base::FilePath>& paths) {
+    const size_t length = paths.size() * kStatBatchFields;
+    v8::Local<v8::ArrayBuffer> buffer =
+        v8::ArrayBuffer::New(isolate, length * sizeof(double));
+    auto* results = static_cast<double*>(buffer->GetBackingStore()->Data());
+    for (const base::FilePath& path : paths) {
+      asar::Archive::Stats stats;
+      StatKind kind = StatKind::kMissing;
+      if (archive_ && archive_->Stat(path, &stats)) {
+        if (stats.is_directory)
+          kind = StatKind::kDirectory;
+        else if (stats.is_link)
+          kind = StatKind::kLink;
+        else
+          kind = StatKind::kFile;
+      }
+      results[0] = static_cast<double>(kind);
+      results[1] = stats.size;
+      results[2] = stats.offset;
+      results += kStatBatchFields;
+    }
+    return v8::Float64Array::New(buffer, 0, length);
+  }
+
   // Returns all files under a directory.
   v8::Local<v8::Value> Readdir(v8::Isolate* isolate,
                                const base::FilePath& path) {
@@ -104,6 +197,52 @@ class Archive : public gin::Wrappable<Archive> {
     return gin::ConvertToV8(isolate, new_path);
   }
 
+  // Reads the whole content of a packed file into a Buffer, decompressing it
+  // if needed.
+  v8::Local<v8::Value> Read(v8::Isolate* isolate, const base::FilePath& path) {
+    asar::Archive::FileInfo info;
+    if (!archive_ || !archive_->GetFileInfo(path, &info) || info.unpacked)
+      return v8::False(isolate);
+    v8::Local<v8::Object> buffer;
+    if (!node::Buffer::New(isolate, info.size).ToLocal(&buffer))
+      return v8::False(isolate);
+    if (!archive_->ReadFile(
+            info, 0,
+            base::make_span(
+                reinterpret_cast<uint8_t*>(node::Buffer::Data(buffer)),
+                info.size)))
+      return v8::False(isolate);
+    return buffer;
+  }
+
+  // Like |Read|, but reads and decompresses the file on the thread pool, and
+  // returns a Promise.
+  v8::Local<v8::Promise> ReadAsync(v8::Isolate* isolate,
+                                   const base::FilePath& path) {
+    gin_helper::Promise<v8::Local<v8::Value>> promise(isolate);
+    v8::Local<v8::Promise> handle = promise.GetHandle();
+
+    asar::Archive::FileInfo info;
+    if (!archive_ || !archive_->GetFileInfo(path, &info) || info.unpacked) {
+      promise.Resolve(v8::False(isolate));
+      return handle;
+    }
+
+    // Threads without a task runner, like the ones of Node's workers, have
+    // nothing to post the reply to.
+    if (!base::SequencedTaskRunnerHandle::IsSet()) {
+      ResolveWithFileContents(std::move(promise),
+                              ReadFileContents(archive_, info));
+      return handle;
+    }
+
+    base::ThreadPool::PostTaskAndReplyWithResult(
+        FROM_HERE, {base::MayBlock(), base::TaskPriority::USER_VISIBLE},
+        base::BindOnce(&ReadFileContents, archive_, info),
+        base::BindOnce(&ResolveWithFileContents, std::move(promise)));
+    return handle;
+  }
+
   // Return the file descriptor.
   int GetFD() const {
     if (!archive_)
@@ -112,7 +251,7 @@ class Archive : public gin::Wrappable<Archive> {
   }
 
  private:
-  std::unique_ptr<asar::Archive> archive_;
+  std::shared_ptr<asar::Archive> archive_;
 
   DISALLOW_COPY_AND_ASSIGN(Archive);
 };
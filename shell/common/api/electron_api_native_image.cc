@@ -14,6 +14,7 @@
 #include "base/strings/pattern.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/task/thread_pool.h"
 #include "base/threading/thread_restrictions.h"
 #include "gin/arguments.h"
 #include "gin/object_template_builder.h"
@@ -24,12 +25,16 @@
 #include "shell/common/gin_converters/file_path_converter.h"
 #include "shell/common/gin_converters/gfx_converter.h"
 #include "shell/common/gin_converters/gurl_converter.h"
+#include "shell/common/gin_converters/image_converter.h"
 #include "shell/common/gin_converters/value_converter.h"
 #include "shell/common/gin_helper/dictionary.h"
 #include "shell/common/gin_helper/function_template_extensions.h"
+#include "shell/common/gin_helper/locker.h"
 #include "shell/common/gin_helper/object_template_builder.h"
+#include "shell/common/gin_helper/promise.h"
 #include "shell/common/node_includes.h"
 #include "shell/common/skia_util.h"
+#include "skia/ext/image_operations.h"
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkImageInfo.h"
 #include "third_party/skia/include/core/SkPixelRef.h"
@@ -38,6 +43,7 @@
 #include "ui/gfx/codec/jpeg_codec.h"
 #include "ui/gfx/codec/png_codec.h"
 #include "ui/gfx/geometry/size.h"
+#include "ui/gfx/geometry/size_conversions.h"
 #include "ui/gfx/image/image_skia.h"
 #include "ui/gfx/image/image_skia_operations.h"
 #include "ui/gfx/image/image_util.h"
@@ -85,6 +91,178 @@ bool IsTemplateFilename(const base::FilePath& path) {
 }
 #endif
 
+skia::ImageOperations::ResizeMethod GetResizeMethod(
+    const base::DictionaryValue& options) {
+  std::string quality;
+  options.GetString("quality", &quality);
+  if (quality == "good")
+    return skia::ImageOperations::ResizeMethod::RESIZE_GOOD;
+  else if (quality == "better")
+    return skia::ImageOperations::ResizeMethod::RESIZE_BETTER;
+  return skia::ImageOperations::ResizeMethod::RESIZE_BEST;
+}
+
+// The functions below run on the thread pool, they must only touch the
+// bitmaps they are given.
+std::unique_ptr<std::vector<unsigned char>> EncodePNG(const SkBitmap& bitmap) {
+  auto encoded = std::make_unique<std::vector<unsigned char>>();
+  if (!gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false, encoded.get()))
+    encoded->clear();
+  return encoded;
+}
+
+std::unique_ptr<std::vector<unsigned char>> EncodeJPEG(const SkBitmap& bitmap,
+                                                       int quality) {
+  auto encoded = std::make_unique<std::vector<unsigned char>>();
+  if (!gfx::JPEGCodec::Encode(bitmap, quality, encoded.get()))
+    encoded->clear();
+  return encoded;
+}
+
+std::vector<gfx::ImageSkiaRep> ResizeImageSkiaReps(
+    const std::vector<gfx::ImageSkiaRep>& reps,
+    skia::ImageOperations::ResizeMethod method,
+    const gfx::Size& size) {
+  // Matches gfx::ImageSkiaOperations::CreateResizedImage(), which resizes
+  // each representation to the DIP |size| at its own scale.
+  std::vector<gfx::ImageSkiaRep> resized;
+  for (const auto& rep : reps) {
+    gfx::Size pixel_size = gfx::ScaleToCeiledSize(size, rep.scale());
+    resized.emplace_back(
+        skia::ImageOperations::Resize(rep.GetBitmap(), method,
+                                      pixel_size.width(), pixel_size.height()),
+        rep.scale());
+  }
+  return resized;
+}
+
+std::vector<gfx::ImageSkiaRep> DecodeImageSkiaRepsFromPath(
+    const base::FilePath& path) {
+  gfx::ImageSkia image_skia;
+  electron::util::PopulateImageSkiaRepsFromPath(&image_skia, path);
+  return image_skia.image_reps();
+}
+
+std::vector<gfx::ImageSkiaRep> DecodeImageSkiaRepsFromBuffer(
+    const std::vector<unsigned char>& data,
+    int width,
+    int height,
+    double scale_factor) {
+  gfx::ImageSkia image_skia;
+  electron::util::AddImageSkiaRepFromBuffer(&image_skia, data.data(),
+                                            data.size(), width, height,
+                                            scale_factor);
+  return image_skia.image_reps();
+}
+
+void FreeEncodedImage(char* data, void* hint) {
+  delete static_cast<std::vector<unsigned char>*>(hint);
+}
+
+// Resolves |promise| with a Buffer that takes over |encoded|.
+void ResolveWithEncodedImage(
+    gin_helper::Promise<v8::Local<v8::Value>> promise,
+    std::unique_ptr<std::vector<unsigned char>> encoded) {
+  v8::Isolate* isolate = promise.isolate();
+  gin_helper::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  v8::Context::Scope context_scope(promise.GetContext());
+
+  v8::Local<v8::Object> buffer;
+  if (encoded->empty()) {
+    buffer = node::Buffer::New(isolate, 0).ToLocalChecked();
+  } else {
+    auto* data = reinterpret_cast<char*>(encoded->data());
+    size_t size = encoded->size();
+    // node frees |encoded| through FreeEncodedImage() even on failure.
+    if (!node::Buffer::New(isolate, data, size, &FreeEncodedImage,
+                           encoded.release())
+             .ToLocal(&buffer)) {
+      promise.RejectWithErrorMessage("Failed to allocate the buffer");
+      return;
+    }
+  }
+  promise.Resolve(buffer);
+}
+
+void ResolveWithImageSkiaReps(gin_helper::Promise<gfx::Image> promise,
+                              std::vector<gfx::ImageSkiaRep> reps) {
+  gfx::ImageSkia image_skia;
+  for (const auto& rep : reps)
+    image_skia.AddRepresentation(rep);
+  promise.Resolve(gfx::Image(image_skia));
+}
+
+// Reads the colorType and alphaType options of toBitmap() and
+// createFromBitmap(), which default to the layout images are stored in.
+bool GetBitmapInfoFromOptions(const gin_helper::Dictionary& options,
+                              int width,
+                              int height,
+                              SkImageInfo* info,
+                              std::string* error) {
+  SkColorType color_type = kN32_SkColorType;
+  SkAlphaType alpha_type = kPremul_SkAlphaType;
+
+  std::string value;
+  if (options.Get("colorType", &value)) {
+    if (value == "bgra") {
+      color_type = kBGRA_8888_SkColorType;
+    } else if (value == "rgba") {
+      color_type = kRGBA_8888_SkColorType;
+    } else {
+      *error = "colorType must be 'bgra' or 'rgba'";
+      return false;
+    }
+  }
+  if (options.Get("alphaType", &value)) {
+    if (value == "premultiplied") {
+      alpha_type = kPremul_SkAlphaType;
+    } else if (value == "unpremultiplied") {
+      alpha_type = kUnpremul_SkAlphaType;
+    } else {
+      *error = "alphaType must be 'premultiplied' or 'unpremultiplied'";
+      return false;
+    }
+  }
+
+  *info = SkImageInfo::Make(width, height, color_type, alpha_type);
+  return true;
+}
+
+// Whether a Buffer can expose |bitmap|'s pixels as they are.
+bool CanShareBitmapPixels(const SkBitmap& bitmap, const SkImageInfo& info) {
+  if (!bitmap.pixelRef())
+    return false;
+  if (bitmap.colorType() != info.colorType() ||
+      bitmap.rowBytes() != info.minRowBytes())
+    return false;
+  // Opaque pixels read the same whether they are premultiplied or not.
+  return bitmap.alphaType() == info.alphaType() ||
+         bitmap.alphaType() == kOpaque_SkAlphaType;
+}
+
+// Returns a Buffer backed by |bitmap|'s pixels, which stay alive until the
+// Buffer's backing store is released. The pixels are marked immutable, as
+// other threads and Skia's caches rely on them not changing, so the Buffer
+// must not be written to.
+v8::Local<v8::Value> WrapBitmapPixels(v8::Isolate* isolate,
+                                      const SkBitmap& bitmap) {
+  SkPixelRef* ref = bitmap.pixelRef();
+  ref->setImmutable();
+  ref->ref();
+  std::unique_ptr<v8::BackingStore> backing_store =
+      v8::ArrayBuffer::NewBackingStore(
+          bitmap.getPixels(), bitmap.computeByteSize(),
+          [](void* data, size_t length, void* deleter_data) {
+            static_cast<SkPixelRef*>(deleter_data)->unref();
+          },
+          ref);
+  auto array_buffer = v8::ArrayBuffer::New(isolate, std::move(backing_store));
+  return node::Buffer::New(isolate, array_buffer, 0,
+                           array_buffer->ByteLength())
+      .ToLocalChecked();
+}
+
 #if defined(OS_WIN)
 base::win::ScopedHICON ReadICOFromPath(int size, const base::FilePath& path) {
   // If file is in asar archive, we extract it to a temp file so LoadImage can
@@ -221,17 +399,32 @@ v8::Local<v8::Value> NativeImage::ToPNG(gin::Arguments* args) {
 }
 
 v8::Local<v8::Value> NativeImage::ToBitmap(gin::Arguments* args) {
-  float scale_factor = GetScaleFactorFromOptions(args);
+  float scale_factor = 1.0f;
+  bool copy = true;
+  gin_helper::Dictionary options;
+  if (!args->GetNext(&options))
+    options = gin::Dictionary::CreateEmpty(args->isolate());
+  options.Get("scaleFactor", &scale_factor);
+  options.Get("copy", &copy);
 
   const SkBitmap bitmap =
       image_.AsImageSkia().GetRepresentation(scale_factor).GetBitmap();
 
-  SkImageInfo info =
-      SkImageInfo::MakeN32Premul(bitmap.width(), bitmap.height());
+  SkImageInfo info;
+  std::string error;
+  if (!GetBitmapInfoFromOptions(options, bitmap.width(), bitmap.height(),
+                                &info, &error)) {
+    gin_helper::ErrorThrower(args->isolate()).ThrowError(error);
+    return v8::Undefined(args->isolate());
+  }
+
+  if (!copy && CanShareBitmapPixels(bitmap, info))
+    return WrapBitmapPixels(args->isolate(), bitmap);
 
   auto array_buffer =
       v8::ArrayBuffer::New(args->isolate(), info.computeMinByteSize());
   auto backing_store = array_buffer->GetBackingStore();
+  // Converts between color and alpha types when they differ.
   if (bitmap.readPixels(info, backing_store->Data(), info.minRowBytes(), 0,
                         0)) {
     return node::Buffer::New(args->isolate(), array_buffer, 0,
@@ -252,6 +445,52 @@ v8::Local<v8::Value> NativeImage::ToJPEG(v8::Isolate* isolate, int quality) {
       .ToLocalChecked();
 }
 
+v8::Local<v8::Promise> NativeImage::ToPNGAsync(gin::Arguments* args) {
+  gin_helper::Promise<v8::Local<v8::Value>> promise(args->isolate());
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+
+  float scale_factor = GetScaleFactorFromOptions(args);
+
+  if (scale_factor == 1.0f) {
+    // Use raw 1x PNG bytes when available
+    scoped_refptr<base::RefCountedMemory> png = image_.As1xPNGBytes();
+    if (png->size() > 0) {
+      auto encoded = std::make_unique<std::vector<unsigned char>>(
+          png->front(), png->front() + png->size());
+      ResolveWithEncodedImage(std::move(promise), std::move(encoded));
+      return handle;
+    }
+  }
+
+  const SkBitmap bitmap =
+      image_.AsImageSkia().GetRepresentation(scale_factor).GetBitmap();
+  base::ThreadPool::PostTaskAndReplyWithResult(
+      FROM_HERE, {base::TaskPriority::USER_VISIBLE},
+      base::BindOnce(&EncodePNG, bitmap),
+      base::BindOnce(&ResolveWithEncodedImage, std::move(promise)));
+  return handle;
+}
+
+v8::Local<v8::Promise> NativeImage::ToJPEGAsync(v8::Isolate* isolate,
+                                                int quality) {
+  gin_helper::Promise<v8::Local<v8::Value>> promise(isolate);
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+
+  // Same as gfx::JPEG1xEncodedDataFromImage(), minus the encoding.
+  const gfx::ImageSkiaRep rep = image_.AsImageSkia().GetRepresentation(1.0f);
+  if (rep.scale() != 1.0f || !rep.GetBitmap().readyToDraw()) {
+    ResolveWithEncodedImage(std::move(promise),
+                            std::make_unique<std::vector<unsigned char>>());
+    return handle;
+  }
+
+  base::ThreadPool::PostTaskAndReplyWithResult(
+      FROM_HERE, {base::TaskPriority::USER_VISIBLE},
+      base::BindOnce(&EncodeJPEG, rep.GetBitmap(), quality),
+      base::BindOnce(&ResolveWithEncodedImage, std::move(promise)));
+  return handle;
+}
+
 std::string NativeImage::ToDataURL(gin::Arguments* args) {
   float scale_factor = GetScaleFactorFromOptions(args);
 
@@ -330,10 +569,9 @@ float NativeImage::GetAspectRatio(const absl::optional<float> scale_factor) {
     return static_cast<float>(size.width()) / static_cast<float>(size.height());
 }
 
-gin::Handle<NativeImage> NativeImage::Resize(gin::Arguments* args,
-                                             base::DictionaryValue options) {
-  float scale_factor = GetScaleFactorFromOptions(args);
-
+absl::optional<gfx::Size> NativeImage::GetResizedSize(
+    float scale_factor,
+    const base::DictionaryValue& options) {
   gfx::Size size = GetSize(scale_factor);
   int width = size.width();
   int height = size.height();
@@ -342,7 +580,7 @@ gin::Handle<NativeImage> NativeImage::Resize(gin::Arguments* args,
   size.SetSize(width, height);
 
   if (width <= 0 && height <= 0) {
-    return CreateEmpty(args->isolate());
+    return absl::nullopt;
   } else if (width_set && !height_set) {
     // Scale height to preserve original aspect ratio
     size.set_height(width);
@@ -353,22 +591,47 @@ gin::Handle<NativeImage> NativeImage::Resize(gin::Arguments* args,
     size.set_width(height);
     size = gfx::ScaleToRoundedSize(size, GetAspectRatio(scale_factor), 1.f);
   }
+  return size;
+}
 
-  skia::ImageOperations::ResizeMethod method =
-      skia::ImageOperations::ResizeMethod::RESIZE_BEST;
-  std::string quality;
-  options.GetString("quality", &quality);
-  if (quality == "good")
-    method = skia::ImageOperations::ResizeMethod::RESIZE_GOOD;
-  else if (quality == "better")
-    method = skia::ImageOperations::ResizeMethod::RESIZE_BETTER;
+gin::Handle<NativeImage> NativeImage::Resize(gin::Arguments* args,
+                                             base::DictionaryValue options) {
+  float scale_factor = GetScaleFactorFromOptions(args);
+
+  absl::optional<gfx::Size> size = GetResizedSize(scale_factor, options);
+  if (!size)
+    return CreateEmpty(args->isolate());
 
   gfx::ImageSkia resized = gfx::ImageSkiaOperations::CreateResizedImage(
-      image_.AsImageSkia(), method, size);
+      image_.AsImageSkia(), GetResizeMethod(options), *size);
   return gin::CreateHandle(
       args->isolate(), new NativeImage(args->isolate(), gfx::Image(resized)));
 }
 
+v8::Local<v8::Promise> NativeImage::ResizeAsync(gin::Arguments* args,
+                                                base::DictionaryValue options) {
+  gin_helper::Promise<gfx::Image> promise(args->isolate());
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+
+  float scale_factor = GetScaleFactorFromOptions(args);
+  absl::optional<gfx::Size> size = GetResizedSize(scale_factor, options);
+  if (!size) {
+    promise.Resolve(gfx::Image());
+    return handle;
+  }
+
+  // ImageSkia is bound to this thread, so only its representations, whose
+  // pixels are never modified, are handed to the thread pool.
+  gfx::ImageSkia image_skia = image_.AsImageSkia();
+  image_skia.EnsureRepsForSupportedScales();
+  base::ThreadPool::PostTaskAndReplyWithResult(
+      FROM_HERE, {base::TaskPriority::USER_VISIBLE},
+      base::BindOnce(&ResizeImageSkiaReps, image_skia.image_reps(),
+                     GetResizeMethod(options), *size),
+      base::BindOnce(&ResolveWithImageSkiaReps, std::move(promise)));
+  return handle;
+}
+
 gin::Handle<NativeImage> NativeImage::Crop(v8::Isolate* isolate,
                                            const gfx::Rect& rect) {
   gfx::ImageSkia cropped =
@@ -489,6 +752,7 @@ gin::Handle<NativeImage> NativeImage::CreateFromBitmap(
   unsigned int width = 0;
   unsigned int height = 0;
   double scale_factor = 1.;
+  bool copy = true;
 
   if (!options.Get("width", &width)) {
     thrower.ThrowError("width is required");
@@ -500,7 +764,12 @@ gin::Handle<NativeImage> NativeImage::CreateFromBitmap(
     return gin::Handle<NativeImage>();
   }
 
-  auto info = SkImageInfo::MakeN32(width, height, kPremul_SkAlphaType);
+  SkImageInfo info;
+  std::string error;
+  if (!GetBitmapInfoFromOptions(options, width, height, &info, &error)) {
+    thrower.ThrowError(error);
+    return gin::Handle<NativeImage>();
+  }
   auto size_bytes = info.computeMinByteSize();
 
   if (size_bytes != node::Buffer::Length(buffer)) {
@@ -509,14 +778,35 @@ gin::Handle<NativeImage> NativeImage::CreateFromBitmap(
   }
 
   options.Get("scaleFactor", &scale_factor);
+  options.Get("copy", &copy);
 
   if (width == 0 || height == 0) {
     return CreateEmpty(thrower.isolate());
   }
 
+  char* data = node::Buffer::Data(buffer);
   SkBitmap bitmap;
-  bitmap.allocN32Pixels(width, height, false);
-  bitmap.writePixels({info, node::Buffer::Data(buffer), bitmap.rowBytes()});
+  if (!copy && info.colorType() == kN32_SkColorType &&
+      info.alphaType() == kPremul_SkAlphaType &&
+      reinterpret_cast<uintptr_t>(data) % info.bytesPerPixel() == 0) {
+    // Adopt the Buffer's memory. Holding on to the backing store keeps it
+    // alive after the Buffer is collected or its ArrayBuffer is detached.
+    auto* backing_store = new std::shared_ptr<v8::BackingStore>(
+        buffer.As<v8::ArrayBufferView>()->Buffer()->GetBackingStore());
+    bitmap.installPixels(
+        info, data, info.minRowBytes(),
+        [](void* addr, void* context) {
+          delete static_cast<std::shared_ptr<v8::BackingStore>*>(context);
+        },
+        backing_store);
+    // The image may be read on other threads and cached by Skia, so the
+    // Buffer must not be written to from now on.
+    bitmap.setImmutable();
+  } else {
+    bitmap.allocN32Pixels(width, height, false);
+    // Converts between color and alpha types when they differ.
+    bitmap.writePixels({info, data, info.minRowBytes()});
+  }
 
   gfx::ImageSkia image_skia =
       gfx::ImageSkia::CreateFromBitmap(bitmap, scale_factor);
@@ -552,6 +842,88 @@ gin::Handle<NativeImage> NativeImage::CreateFromBuffer(
   return Create(args->isolate(), gfx::Image(image_skia));
 }
 
+// static
+v8::Local<v8::Promise> NativeImage::CreateFromPathAsync(
+    v8::Isolate* isolate,
+    const base::FilePath& path) {
+  gin_helper::Promise<gin::Handle<NativeImage>> promise(isolate);
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+
+  base::FilePath image_path = NormalizePath(path);
+#if defined(OS_WIN)
+  // Icons are loaded through the HICON cache of the NativeImage itself.
+  if (image_path.MatchesExtension(FILE_PATH_LITERAL(".ico"))) {
+    promise.Resolve(CreateFromPath(isolate, image_path));
+    return handle;
+  }
+#endif
+
+  base::ThreadPool::PostTaskAndReplyWithResult(
+      FROM_HERE, {base::MayBlock(), base::TaskPriority::USER_VISIBLE},
+      base::BindOnce(&DecodeImageSkiaRepsFromPath, image_path),
+      base::BindOnce(&NativeImage::OnDecodedFromPath, std::move(promise),
+                     image_path));
+  return handle;
+}
+
+// static
+void NativeImage::OnDecodedFromPath(
+    gin_helper::Promise<gin::Handle<NativeImage>> promise,
+    const base::FilePath& path,
+    std::vector<gfx::ImageSkiaRep> reps) {
+  v8::Isolate* isolate = promise.isolate();
+  gin_helper::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  v8::Context::Scope context_scope(promise.GetContext());
+
+  gfx::ImageSkia image_skia;
+  for (const auto& rep : reps)
+    image_skia.AddRepresentation(rep);
+  gin::Handle<NativeImage> handle = Create(isolate, gfx::Image(image_skia));
+#if defined(OS_MAC)
+  if (IsTemplateFilename(path))
+    handle->SetTemplateImage(true);
+#endif
+  promise.Resolve(handle);
+}
+
+// static
+v8::Local<v8::Promise> NativeImage::CreateFromBufferAsync(
+    gin_helper::ErrorThrower thrower,
+    v8::Local<v8::Value> buffer,
+    gin::Arguments* args) {
+  if (!node::Buffer::HasInstance(buffer)) {
+    thrower.ThrowError("buffer must be a node Buffer");
+    return v8::Local<v8::Promise>();
+  }
+
+  gin_helper::Promise<gfx::Image> promise(args->isolate());
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+
+  int width = 0;
+  int height = 0;
+  double scale_factor = 1.;
+
+  gin_helper::Dictionary options;
+  if (args->GetNext(&options)) {
+    options.Get("width", &width);
+    options.Get("height", &height);
+    options.Get("scaleFactor", &scale_factor);
+  }
+
+  // The Buffer may change while it is being decoded.
+  const auto* data =
+      reinterpret_cast<const unsigned char*>(node::Buffer::Data(buffer));
+  std::vector<unsigned char> contents(data,
+                                      data + node::Buffer::Length(buffer));
+  base::ThreadPool::PostTaskAndReplyWithResult(
+      FROM_HERE, {base::TaskPriority::USER_VISIBLE},
+      base::BindOnce(&DecodeImageSkiaRepsFromBuffer, std::move(contents),
+                     width, height, scale_factor),
+      base::BindOnce(&ResolveWithImageSkiaReps, std::move(promise)));
+  return handle;
+}
+
 // static
 gin::Handle<NativeImage> NativeImage::CreateFromDataURL(v8::Isolate* isolate,
                                                         const GURL& url) {
@@ -588,7 +960,9 @@ gin::ObjectTemplateBuilder NativeImage::GetObjectTemplateBuilder(
   return gin::ObjectTemplateBuilder(isolate, GetTypeName(),
                                     constructor->InstanceTemplate())
       .SetMethod("toPNG", &NativeImage::ToPNG)
+      .SetMethod("toPNGAsync", &NativeImage::ToPNGAsync)
       .SetMethod("toJPEG", &NativeImage::ToJPEG)
+      .SetMethod("toJPEGAsync", &NativeImage::ToJPEGAsync)
       .SetMethod("toBitmap", &NativeImage::ToBitmap)
       .SetMethod("getBitmap", &NativeImage::GetBitmap)
       .SetMethod("getScaleFactors", &NativeImage::GetScaleFactors)
@@ -601,6 +975,7 @@ gin::ObjectTemplateBuilder NativeImage::GetObjectTemplateBuilder(
       .SetProperty("isMacTemplateImage", &NativeImage::IsTemplateImage,
                    &NativeImage::SetTemplateImage)
       .SetMethod("resize", &NativeImage::Resize)
+      .SetMethod("resizeAsync", &NativeImage::ResizeAsync)
       .SetMethod("crop", &NativeImage::Crop)
       .SetMethod("getAspectRatio", &NativeImage::GetAspectRatio)
       .SetMethod("addRepresentation", &NativeImage::AddRepresentation);
@@ -632,8 +1007,12 @@ void Initialize(v8::Local<v8::Object> exports,
 
   native_image.SetMethod("createEmpty", &NativeImage::CreateEmpty);
   native_image.SetMethod("createFromPath", &NativeImage::CreateFromPath);
+  native_image.SetMethod("createFromPathAsync",
+                         &NativeImage::CreateFromPathAsync);
   native_image.SetMethod("createFromBitmap", &NativeImage::CreateFromBitmap);
   native_image.SetMethod("createFromBuffer", &NativeImage::CreateFromBuffer);
+  native_image.SetMethod("createFromBufferAsync",
+                         &NativeImage::CreateFromBufferAsync);
   native_image.SetMethod("createFromDataURL", &NativeImage::CreateFromDataURL);
   native_image.SetMethod("createFromNamedImage",
                          &NativeImage::CreateFromNamedImage);
@@ -13,6 +13,7 @@
 #include "gin/handle.h"
 #include "gin/wrappable.h"
 #include "shell/common/gin_helper/error_thrower.h"
+#include "shell/common/gin_helper/promise.h"
 #include "ui/gfx/image/image.h"
 
 #if defined(OS_WIN)
@@ -27,6 +28,7 @@ class FilePath;
 }
 
 namespace gfx {
+class ImageSkiaRep;
 class Rect;
 class Size;
 }  // namespace gfx
@@ -56,6 +58,10 @@ class NativeImage : public gin::Wrappable<NativeImage> {
                                                  size_t length);
   static gin::Handle<NativeImage> CreateFromPath(v8::Isolate* isolate,
                                                  const base::FilePath& path);
+  // Reads and decodes the image on the thread pool.
+  static v8::Local<v8::Promise> CreateFromPathAsync(
+      v8::Isolate* isolate,
+      const base::FilePath& path);
   static gin::Handle<NativeImage> CreateFromBitmap(
       gin_helper::ErrorThrower thrower,
       v8::Local<v8::Value> buffer,
@@ -64,6 +70,11 @@ class NativeImage : public gin::Wrappable<NativeImage> {
       gin_helper::ErrorThrower thrower,
       v8::Local<v8::Value> buffer,
       gin::Arguments* args);
+  // Decodes a copy of |buffer| on the thread pool.
+  static v8::Local<v8::Promise> CreateFromBufferAsync(
+      gin_helper::ErrorThrower thrower,
+      v8::Local<v8::Value> buffer,
+      gin::Arguments* args);
   static gin::Handle<NativeImage> CreateFromDataURL(v8::Isolate* isolate,
                                                     const GURL& url);
   static gin::Handle<NativeImage> CreateFromNamedImage(gin::Arguments* args,
@@ -104,13 +115,21 @@ class NativeImage : public gin::Wrappable<NativeImage> {
 
  private:
   v8::Local<v8::Value> ToPNG(gin::Arguments* args);
+  v8::Local<v8::Promise> ToPNGAsync(gin::Arguments* args);
   v8::Local<v8::Value> ToJPEG(v8::Isolate* isolate, int quality);
+  v8::Local<v8::Promise> ToJPEGAsync(v8::Isolate* isolate, int quality);
   v8::Local<v8::Value> ToBitmap(gin::Arguments* args);
   std::vector<float> GetScaleFactors();
   v8::Local<v8::Value> GetBitmap(gin::Arguments* args);
   v8::Local<v8::Value> GetNativeHandle(gin_helper::ErrorThrower thrower);
+  // Returns the size resize() scales to, or nullopt for an empty result.
+  absl::optional<gfx::Size> GetResizedSize(
+      float scale_factor,
+      const base::DictionaryValue& options);
   gin::Handle<NativeImage> Resize(gin::Arguments* args,
                                   base::DictionaryValue options);
+  v8::Local<v8::Promise> ResizeAsync(gin::Arguments* args,
+                                     base::DictionaryValue options);
   gin::Handle<NativeImage> Crop(v8::Isolate* isolate, const gfx::Rect& rect);
   std::string ToDataURL(gin::Arguments* args);
   bool IsEmpty();
@@ -120,6 +139,11 @@ class NativeImage : public gin::Wrappable<NativeImage> {
 
   void AdjustAmountOfExternalAllocatedMemory(bool add);
 
+  static void OnDecodedFromPath(
+      gin_helper::Promise<gin::Handle<NativeImage>> promise,
+      const base::FilePath& path,
+      std::vector<gfx::ImageSkiaRep> reps);
+
   // Mark the image as template image.
   void SetTemplateImage(bool setAsTemplate);
   // Determine if the image is a template image.
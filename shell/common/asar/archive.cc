@@ -4,11 +4,15 @@
 
 #include "shell/common/asar/archive.h"
 
+#include <algorithm>
+#include <cstring>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "base/bind.h"
 #include "base/check.h"
+#include "base/command_line.h"
 #include "base/files/file.h"
 #include "base/files/file_util.h"
 #include "base/json/json_reader.h"
@@ -16,110 +20,79 @@
 #include "base/pickle.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/task/post_task.h"
+#include "base/threading/sequenced_task_runner_handle.h"
 #include "base/threading/thread_restrictions.h"
 #include "base/values.h"
+#include "shell/common/asar/archive_index.h"
+#include "shell/common/asar/block_decoder.h"
+#include "shell/common/asar/extraction_cache.h"
 #include "shell/common/asar/scoped_temporary_file.h"
+#include "shell/common/options_switches.h"
 
 #if defined(OS_WIN)
 #include <io.h>
 #endif
 
+#if defined(OS_POSIX)
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+
 namespace asar {
 
 namespace {
 
-#if defined(OS_WIN)
-const char kSeparators[] = "\\/";
-#else
-const char kSeparators[] = "/";
-#endif
+const base::FilePath::CharType kIndexExtension[] = FILE_PATH_LITERAL("index");
 
-bool GetNodeFromPath(std::string path,
-                     const base::DictionaryValue* root,
-                     const base::DictionaryValue** out);
-
-// Gets the "files" from "dir".
-bool GetFilesNode(const base::DictionaryValue* root,
-                  const base::DictionaryValue* dir,
-                  const base::DictionaryValue** out) {
-  // Test for symbol linked directory.
-  std::string link;
-  if (dir->GetStringWithoutPathExpansion("link", &link)) {
-    const base::DictionaryValue* linked_node = nullptr;
-    if (!GetNodeFromPath(link, root, &linked_node))
-      return false;
-    dir = linked_node;
-  }
+// Number of decompressed blocks kept around for partial reads.
+constexpr size_t kBlockCacheSize = 16;
 
-  return dir->GetDictionaryWithoutPathExpansion("files", out);
-}
+// Reads covering fewer whole blocks are decoded on the calling thread.
+constexpr size_t kMinParallelBlocks = 2;
 
-// Gets sub-file "name" from "dir".
-bool GetChildNode(const base::DictionaryValue* root,
-                  const std::string& name,
-                  const base::DictionaryValue* dir,
-                  const base::DictionaryValue** out) {
-  if (name.empty()) {
-    *out = root;
-    return true;
-  }
-
-  const base::DictionaryValue* files = nullptr;
-  return GetFilesNode(root, dir, &files) &&
-         files->GetDictionaryWithoutPathExpansion(name, out);
-}
-
-// Gets the node of "path" from "root".
-bool GetNodeFromPath(std::string path,
-                     const base::DictionaryValue* root,
-                     const base::DictionaryValue** out) {
-  if (path.empty()) {
-    *out = root;
-    return true;
-  }
-
-  const base::DictionaryValue* dir = root;
-  for (size_t delimiter_position = path.find_first_of(kSeparators);
-       delimiter_position != std::string::npos;
-       delimiter_position = path.find_first_of(kSeparators)) {
-    const base::DictionaryValue* child = nullptr;
-    if (!GetChildNode(root, path.substr(0, delimiter_position), dir, &child))
-      return false;
-
-    dir = child;
-    path.erase(0, delimiter_position + 1);
-  }
-
-  return GetChildNode(root, path, dir, out);
-}
+// Upper bound of a single read-ahead hint, so that streaming a huge file does
+// not evict everything else from the page cache.
+constexpr uint64_t kMaxReadAheadSize = 8 * 1024 * 1024;
 
 bool FillFileInfoWithNode(Archive::FileInfo* info,
                           uint32_t header_size,
-                          const base::DictionaryValue* node) {
-  int size;
-  if (!node->GetInteger("size", &size))
+                          const ArchiveIndex& index,
+                          const ArchiveIndex::Node* node) {
+  if (node->flags & ArchiveIndex::kInvalid)
     return false;
-  info->size = static_cast<uint32_t>(size);
 
-  if (node->GetBoolean("unpacked", &info->unpacked) && info->unpacked)
+  info->size = node->size;
+  info->unpacked = node->flags & ArchiveIndex::kUnpacked;
+  if (info->unpacked)
     return true;
 
-  std::string offset;
-  if (!node->GetString("offset", &offset))
-    return false;
-  if (!base::StringToUint64(offset, &info->offset))
-    return false;
-  info->offset += header_size;
-
-  node->GetBoolean("executable", &info->executable);
-
+  info->offset = node->offset + header_size;
+  info->executable = node->flags & ArchiveIndex::kExecutable;
+  info->compressed = node->flags & ArchiveIndex::kCompressed;
+  if (info->compressed) {
+    info->block_size = index.GetBlockSize(*node);
+    info->block_offsets = index.GetBlockOffsets(*node);
+  }
+  if (node->flags & ArchiveIndex::kIntegrity) {
+    info->integrity_block_size = node->integrity_block_size;
+    info->integrity_hashes = index.GetBlockHashes(*node);
+  }
   return true;
 }
 
+// Returns the uncompressed size of |block| of a compressed file.
+uint32_t GetBlockLength(const Archive::FileInfo& info, size_t block) {
+  uint64_t start = static_cast<uint64_t>(block) * info.block_size;
+  return std::min<uint64_t>(info.block_size, info.size - start);
+}
+
 }  // namespace
 
 Archive::Archive(const base::FilePath& path)
-    : initialized_(false), path_(path), file_(base::File::FILE_OK) {
+    : initialized_(false),
+      path_(path),
+      file_(base::File::FILE_OK),
+      block_cache_(kBlockCacheSize) {
   base::ThreadRestrictions::ScopedAllowIO allow_io;
   file_.Initialize(path_, base::File::FLAG_OPEN | base::File::FLAG_READ);
 #if defined(OS_WIN)
@@ -142,6 +115,10 @@ Archive::~Archive() {
 }
 
 bool Archive::Init() {
+  return InitWithSharedIndex(base::ReadOnlySharedMemoryRegion());
+}
+
+bool Archive::InitWithSharedIndex(base::ReadOnlySharedMemoryRegion index) {
   // Should only be initialized once
   CHECK(!initialized_);
   initialized_ = true;
@@ -174,7 +151,47 @@ bool Archive::Init() {
     return false;
   }
 
-  buf.resize(size);
+  std::string header;
+  if (!ReadHeader(size, &header))
+    return false;
+
+  if (index.IsValid())
+    index_ = ArchiveIndex::CreateFromSharedMemory(std::move(index), header);
+  if (!index_ && !ReadIndex(header))
+    return false;
+
+  header_size_ = 8 + size;
+
+  // Map the whole archive so packed files can be read without a syscall. This
+  // only reserves address space, and failing here is not fatal.
+  {
+    base::ThreadRestrictions::ScopedAllowIO allow_io;
+    if (!mapped_file_.Initialize(file_.Duplicate()))
+      DLOG(WARNING) << "Failed to map " << path_.value();
+  }
+  return true;
+}
+
+base::ReadOnlySharedMemoryRegion Archive::DuplicateSharedIndex() {
+  if (!index_)
+    return base::ReadOnlySharedMemoryRegion();
+
+  base::AutoLock auto_lock(shared_index_lock_);
+  if (!shared_index_.IsValid()) {
+    base::span<const uint8_t> data = index_->data();
+    base::MappedReadOnlyRegion region =
+        base::ReadOnlySharedMemoryRegion::Create(data.size());
+    if (!region.IsValid())
+      return base::ReadOnlySharedMemoryRegion();
+    memcpy(region.mapping.memory(), data.data(), data.size());
+    shared_index_ = std::move(region.region);
+  }
+  return shared_index_.Duplicate();
+}
+
+bool Archive::ReadHeader(uint32_t size, std::string* header) {
+  std::vector<char> buf(size);
+  int len;
   {
     base::ThreadRestrictions::ScopedAllowIO allow_io;
     len = file_.ReadAtCurrentPos(buf.data(), buf.size());
@@ -184,96 +201,113 @@ bool Archive::Init() {
     return false;
   }
 
-  std::string header;
   if (!base::PickleIterator(base::Pickle(buf.data(), buf.size()))
-           .ReadString(&header)) {
+           .ReadString(header)) {
     LOG(ERROR) << "Failed to parse header from " << path_.value();
     return false;
   }
+  return true;
+}
+
+bool Archive::ReadIndex(const std::string& header) {
+  // Prefer a prebuilt index shipped next to the archive, which saves parsing
+  // the JSON header altogether. It is only used if it was built from this
+  // exact header.
+  const base::FilePath index_path = path_.AddExtension(kIndexExtension);
+  index_ = ArchiveIndex::CreateFromFile(index_path, header);
+  if (index_)
+    return true;
 
   absl::optional<base::Value> value = base::JSONReader::Read(header);
   if (!value || !value->is_dict()) {
     LOG(ERROR) << "Failed to parse header";
     return false;
   }
+  index_ = ArchiveIndex::CreateFromHeader(*value, header);
+  if (!index_) {
+    LOG(ERROR) << "Failed to index header from " << path_.value();
+    return false;
+  }
+
+  // The index lives next to the archive so that it is as trusted as the
+  // archive itself, which means it has to be written while packaging, before
+  // the app is signed or installed.
+  if (base::CommandLine::ForCurrentProcess()->HasSwitch(
+          electron::switches::kAsarWriteIndex) &&
+      !index_->WriteToFile(index_path)) {
+    LOG(ERROR) << "Failed to write asar index " << index_path.value();
+  }
 
-  header_size_ = 8 + size;
-  header_ = base::DictionaryValue::From(
-      base::Value::ToUniquePtrValue(std::move(*value)));
   return true;
 }
 
+const ArchiveIndex::Node* Archive::FindNode(const base::FilePath& path) const {
+  if (!index_)
+    return nullptr;
+#if defined(OS_WIN)
+  return index_->Lookup(path.AsUTF8Unsafe());
+#else
+  return index_->Lookup(path.value());
+#endif
+}
+
 bool Archive::GetFileInfo(const base::FilePath& path, FileInfo* info) const {
-  if (!header_)
+  const ArchiveIndex::Node* node = FindNode(path);
+  if (!node)
     return false;
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+  node = index_->ResolveLink(node);
+  if (!node)
     return false;
 
-  std::string link;
-  if (node->GetString("link", &link))
-    return GetFileInfo(base::FilePath::FromUTF8Unsafe(link), info);
-
-  return FillFileInfoWithNode(info, header_size_, node);
+  return FillFileInfoWithNode(info, header_size_, *index_, node);
 }
 
 bool Archive::Stat(const base::FilePath& path, Stats* stats) const {
-  if (!header_)
+  const ArchiveIndex::Node* node = FindNode(path);
+  if (!node)
     return false;
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
-    return false;
-
-  if (node->FindKey("link")) {
+  if (node->flags & ArchiveIndex::kLink) {
     stats->is_file = false;
     stats->is_link = true;
     return true;
   }
 
-  if (node->FindKey("files")) {
+  if (node->flags & ArchiveIndex::kDirectory) {
     stats->is_file = false;
     stats->is_directory = true;
     return true;
   }
 
-  return FillFileInfoWithNode(stats, header_size_, node);
+  return FillFileInfoWithNode(stats, header_size_, *index_, node);
 }
 
 bool Archive::Readdir(const base::FilePath& path,
                       std::vector<base::FilePath>* files) const {
-  if (!header_)
+  const ArchiveIndex::Node* node = FindNode(path);
+  if (!node)
     return false;
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+  node = index_->ResolveLink(node);
+  if (!node || !(node->flags & ArchiveIndex::kDirectory))
     return false;
 
-  const base::DictionaryValue* files_node;
-  if (!GetFilesNode(header_.get(), node, &files_node))
-    return false;
-
-  base::DictionaryValue::Iterator iter(*files_node);
-  while (!iter.IsAtEnd()) {
-    files->push_back(base::FilePath::FromUTF8Unsafe(iter.key()));
-    iter.Advance();
-  }
+  base::span<const ArchiveIndex::Node> children = index_->GetChildren(*node);
+  files->reserve(files->size() + children.size());
+  for (const ArchiveIndex::Node& child : children)
+    files->push_back(base::FilePath::FromUTF8Unsafe(index_->GetName(child)));
   return true;
 }
 
 bool Archive::Realpath(const base::FilePath& path,
                        base::FilePath* realpath) const {
-  if (!header_)
+  const ArchiveIndex::Node* node = FindNode(path);
+  if (!node)
     return false;
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
-    return false;
-
-  std::string link;
-  if (node->GetString("link", &link)) {
-    *realpath = base::FilePath::FromUTF8Unsafe(link);
+  if (node->flags & ArchiveIndex::kLink) {
+    *realpath = base::FilePath::FromUTF8Unsafe(index_->GetLinkTarget(*node));
     return true;
   }
 
@@ -282,7 +316,7 @@ bool Archive::Realpath(const base::FilePath& path,
 }
 
 bool Archive::CopyFileOut(const base::FilePath& path, base::FilePath* out) {
-  if (!header_)
+  if (!index_)
     return false;
 
   base::AutoLock auto_lock(external_files_lock_);
@@ -293,6 +327,12 @@ bool Archive::CopyFileOut(const base::FilePath& path, base::FilePath* out) {
     return true;
   }
 
+  auto cached_it = cached_files_.find(path.value());
+  if (cached_it != cached_files_.end()) {
+    *out = cached_it->second;
+    return true;
+  }
+
   FileInfo info;
   if (!GetFileInfo(path, &info))
     return false;
@@ -302,9 +342,43 @@ bool Archive::CopyFileOut(const base::FilePath& path, base::FilePath* out) {
     return true;
   }
 
+  // Compressed files, and files of archives that could not be mapped, are
+  // read into memory first.
+  base::span<const uint8_t> contents;
+  std::vector<uint8_t> buffer;
+  if (!GetFileContents(info, &contents)) {
+    buffer.resize(info.size);
+    if (!ReadFile(info, 0, buffer))
+      return false;
+    contents = buffer;
+  }
+
+  switch (GetExtractMode()) {
+    case ExtractMode::kCache:
+      if (ExtractToCache(contents, path.BaseName(), info.executable, out)) {
+        cached_files_[path.value()] = *out;
+        return true;
+      }
+      break;
+#if defined(OS_LINUX)
+    case ExtractMode::kMemory: {
+      auto memory_file = std::make_unique<ScopedTemporaryFile>();
+      if (memory_file->InitInMemory(path.BaseName().value(), contents)) {
+        *out = memory_file->path();
+        external_files_[path.value()] = std::move(memory_file);
+        return true;
+      }
+      break;
+    }
+#endif
+    default:
+      break;
+  }
+
+  // Fall back to a temporary file on disk.
   auto temp_file = std::make_unique<ScopedTemporaryFile>();
   base::FilePath::StringType ext = path.Extension();
-  if (!temp_file->InitFromFile(&file_, ext, info.offset, info.size))
+  if (!temp_file->InitFromContents(ext, contents))
     return false;
 
 #if defined(OS_POSIX)
@@ -319,6 +393,170 @@ bool Archive::CopyFileOut(const base::FilePath& path, base::FilePath* out) {
   return true;
 }
 
+bool Archive::GetFileContents(const FileInfo& info,
+                              base::span<const uint8_t>* contents) const {
+  if (info.unpacked || info.compressed || !IsMapped(info.offset, info.size))
+    return false;
+
+  *contents = base::make_span(mapped_file_.data() + info.offset, info.size);
+  return true;
+}
+
+bool Archive::ReadFile(const FileInfo& info,
+                       uint64_t offset,
+                       base::span<uint8_t> buffer) {
+  if (info.unpacked || offset > info.size || buffer.size() > info.size - offset)
+    return false;
+
+  if (!info.compressed)
+    return ReadRaw(info.offset + offset, buffer);
+
+  if (buffer.empty())
+    return true;
+
+  // Blocks covered entirely by the read are decompressed straight into
+  // |buffer|, while the ones at the edges go through the cache, as sequential
+  // readers like the URL loader are likely to ask for the rest of them next.
+  const uint64_t end = offset + buffer.size();
+  size_t block = offset / info.block_size;
+  const size_t last_block = (end - 1) / info.block_size;
+  size_t first_whole_block = 0;
+  size_t whole_blocks = 0;
+  for (; block <= last_block; ++block) {
+    const uint64_t block_start = static_cast<uint64_t>(block) * info.block_size;
+    const uint64_t block_end = block_start + GetBlockLength(info, block);
+    if (block_start >= offset && block_end <= end) {
+      if (whole_blocks++ == 0)
+        first_whole_block = block;
+      continue;
+    }
+
+    scoped_refptr<base::RefCountedBytes> cached = GetCachedBlock(info, block);
+    if (!cached)
+      return false;
+    const uint64_t copy_start = std::max(offset, block_start);
+    const uint64_t copy_end = std::min(end, block_end);
+    memcpy(buffer.data() + (copy_start - offset),
+           cached->front() + (copy_start - block_start),
+           copy_end - copy_start);
+  }
+
+  auto decode_whole_block = base::BindRepeating(
+      [](Archive* archive, const FileInfo* info, base::span<uint8_t> buffer,
+         uint64_t offset, size_t first_block, size_t index) {
+        const size_t block = first_block + index;
+        const uint64_t block_start =
+            static_cast<uint64_t>(block) * info->block_size;
+        return archive->DecodeBlock(
+            *info, block,
+            buffer.subspan(block_start - offset, GetBlockLength(*info, block)));
+      },
+      base::Unretained(this), base::Unretained(&info), buffer, offset,
+      first_whole_block);
+
+  // Blocks are spread over the thread pool, unless there is only one or the
+  // thread pool may not be running, e.g. before the message loop starts.
+  if (whole_blocks >= kMinParallelBlocks &&
+      base::SequencedTaskRunnerHandle::IsSet())
+    return DecodeBlocksInParallel(whole_blocks, std::move(decode_whole_block));
+  for (size_t i = 0; i < whole_blocks; ++i) {
+    if (!decode_whole_block.Run(i))
+      return false;
+  }
+  return true;
+}
+
+void Archive::WillRead(const FileInfo& info,
+                       uint64_t offset,
+                       uint64_t length) const {
+  if (info.unpacked || length == 0 || offset >= info.size)
+    return;
+
+  // Translate the range into the bytes stored in the archive.
+  uint64_t end = std::min<uint64_t>(offset + length, info.size);
+  if (info.compressed) {
+    offset = info.block_offsets[offset / info.block_size];
+    end = info.block_offsets[(end - 1) / info.block_size + 1];
+  }
+  length = std::min(end - offset, kMaxReadAheadSize);
+
+#if defined(OS_LINUX) || defined(OS_CHROMEOS) || defined(OS_ANDROID)
+  // Only a hint, failures are harmless.
+  posix_fadvise(fd_, info.offset + offset, length, POSIX_FADV_WILLNEED);
+#elif defined(OS_MAC)
+  struct radvisory advisory;
+  advisory.ra_offset = info.offset + offset;
+  advisory.ra_count = static_cast<int>(length);
+  fcntl(fd_, F_RDADVISE, &advisory);
+#endif
+}
+
+bool Archive::ReadRaw(uint64_t offset, base::span<uint8_t> buffer) {
+  if (IsMapped(offset, buffer.size())) {
+    memcpy(buffer.data(), mapped_file_.data() + offset, buffer.size());
+    return true;
+  }
+
+  return file_.Read(offset, reinterpret_cast<char*>(buffer.data()),
+                    buffer.size()) == static_cast<int>(buffer.size());
+}
+
+bool Archive::DecodeBlock(const FileInfo& info,
+                          size_t block,
+                          base::span<uint8_t> output) {
+  const uint64_t offset = info.offset + info.block_offsets[block];
+  const uint32_t size =
+      info.block_offsets[block + 1] - info.block_offsets[block];
+
+  if (IsMapped(offset, size)) {
+    return DecompressBlock(base::make_span(mapped_file_.data() + offset, size),
+                           output);
+  }
+
+  std::vector<uint8_t> compressed(size);
+  return ReadRaw(offset, compressed) && DecompressBlock(compressed, output);
+}
+
+bool Archive::IsMapped(uint64_t offset, uint64_t size) const {
+  if (!mapped_file_.IsValid() || offset > mapped_file_.length() ||
+      size > mapped_file_.length() - offset)
+    return false;
+
+#if defined(OS_POSIX)
+  // Touching pages of the mapping past the end of the file raises SIGBUS
+  // instead of failing a read, which happens when the archive is truncated
+  // underneath us, e.g. by an updater overwriting it in place. Make sure the
+  // range is still backed by the file, and let the caller go through pread()
+  // otherwise. Windows doesn't allow truncating a mapped file.
+  struct stat file_stat;
+  if (fstat(fd_, &file_stat) != 0 ||
+      static_cast<uint64_t>(file_stat.st_size) < offset + size)
+    return false;
+#endif
+  return true;
+}
+
+scoped_refptr<base::RefCountedBytes> Archive::GetCachedBlock(
+    const FileInfo& info,
+    size_t block) {
+  const uint64_t key = info.offset + info.block_offsets[block];
+  {
+    base::AutoLock auto_lock(block_cache_lock_);
+    auto it = block_cache_.Get(key);
+    if (it != block_cache_.end())
+      return it->second;
+  }
+
+  auto bytes = base::MakeRefCounted<base::RefCountedBytes>(
+      GetBlockLength(info, block));
+  if (!DecodeBlock(info, block, bytes->data()))
+    return nullptr;
+
+  base::AutoLock auto_lock(block_cache_lock_);
+  block_cache_.Put(key, bytes);
+  return bytes;
+}
+
 int Archive::GetFD() const {
   return fd_;
 }
@@ -6,16 +6,19 @@
 #define SHELL_COMMON_ASAR_ARCHIVE_H_
 
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "base/containers/mru_cache.h"
+#include "base/containers/span.h"
 #include "base/files/file.h"
 #include "base/files/file_path.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/memory/read_only_shared_memory_region.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/synchronization/lock.h"
-
-namespace base {
-class DictionaryValue;
-}
+#include "shell/common/asar/archive_index.h"
 
 namespace asar {
 
@@ -26,11 +29,27 @@ class ScopedTemporaryFile;
 class Archive {
  public:
   struct FileInfo {
-    FileInfo() : unpacked(false), executable(false), size(0), offset(0) {}
+    FileInfo()
+        : unpacked(false),
+          executable(false),
+          compressed(false),
+          size(0),
+          offset(0),
+          block_size(0),
+          integrity_block_size(0) {}
     bool unpacked;
     bool executable;
+    bool compressed;
+    // The uncompressed size.
     uint32_t size;
     uint64_t offset;
+    // The layout of compressed files, see |ArchiveIndex::GetBlockOffsets|.
+    uint32_t block_size;
+    base::span<const uint32_t> block_offsets;
+    // The hashes of the uncompressed blocks of files with integrity, see
+    // |ArchiveIndex::GetBlockHashes|. |integrity_block_size| is 0 otherwise.
+    uint32_t integrity_block_size;
+    base::span<const uint8_t> integrity_hashes;
   };
 
   struct Stats : public FileInfo {
@@ -46,6 +65,15 @@ class Archive {
   // Read and parse the header.
   bool Init();
 
+  // Like |Init|, but adopts the index another process built for this archive
+  // instead of parsing the header. Parses the header if |index| is invalid or
+  // was not built from the header of the archive on disk.
+  bool InitWithSharedIndex(base::ReadOnlySharedMemoryRegion index);
+
+  // Returns a read-only copy of the index that can be handed to other
+  // processes. The shared region is created on first use.
+  base::ReadOnlySharedMemoryRegion DuplicateSharedIndex();
+
   // Get the info of a file.
   bool GetFileInfo(const base::FilePath& path, FileInfo* info) const;
 
@@ -61,20 +89,87 @@ class Archive {
 
   // Copy the file into a temporary file, and return the new path.
   // For unpacked file, this method will return its real path.
+  // Depending on --asar-extract-mode the copy may instead live in memory or in
+  // a persistent cache shared across launches.
   bool CopyFileOut(const base::FilePath& path, base::FilePath* out);
 
+  // Points |contents| at the bytes of a packed file inside the read-only
+  // mapping of the archive, which stays valid for the lifetime of this object.
+  // Returns false for unpacked or compressed files, or when the file's range
+  // is not mapped, in which case callers should fall back to |ReadFile|. The
+  // range is only checked against the size of the archive at the time of the
+  // call, so callers should not hold on to |contents| for long if the archive
+  // may be truncated in place.
+  bool GetFileContents(const FileInfo& info,
+                       base::span<const uint8_t>* contents) const;
+
+  // Fills |buffer| with the bytes of a packed file starting at |offset|,
+  // decompressing them if needed. Blocks spanned by the read are decompressed
+  // in parallel, and partially read ones are kept in a small cache for the
+  // reads that follow. Returns false if the range is out of bounds or the
+  // data is corrupt.
+  bool ReadFile(const FileInfo& info,
+                uint64_t offset,
+                base::span<uint8_t> buffer);
+
+  // Hints the OS that the |length| bytes at |offset| of a packed file are
+  // about to be read, so that it can start reading them ahead.
+  void WillRead(const FileInfo& info, uint64_t offset, uint64_t length) const;
+
   // Returns the file's fd.
   int GetFD() const;
 
   base::FilePath path() const { return path_; }
 
+  // Returns the index of the header, or null before a successful |Init|.
+  const ArchiveIndex* index() const { return index_.get(); }
+
  private:
+  // Reads the JSON header of |size| bytes that follows the header size.
+  bool ReadHeader(uint32_t size, std::string* header);
+
+  // Indexes the JSON |header|.
+  bool ReadIndex(const std::string& header);
+
+  // Returns the node at |path| without following a link at the end.
+  const ArchiveIndex::Node* FindNode(const base::FilePath& path) const;
+
+  // Reads raw bytes at |offset| of the archive.
+  bool ReadRaw(uint64_t offset, base::span<uint8_t> buffer);
+
+  // Returns whether the |size| bytes at |offset| of the archive can be read
+  // from |mapped_file_|, which also requires the file to still cover them.
+  bool IsMapped(uint64_t offset, uint64_t size) const;
+
+  // Decompresses |block| of a compressed file into |output|.
+  bool DecodeBlock(const FileInfo& info,
+                   size_t block,
+                   base::span<uint8_t> output);
+
+  // Returns |block| of a compressed file from |block_cache_|, decompressing
+  // it on a miss. Returns null on failure.
+  scoped_refptr<base::RefCountedBytes> GetCachedBlock(const FileInfo& info,
+                                                      size_t block);
+
   bool initialized_;
   const base::FilePath path_;
   base::File file_;
   int fd_ = -1;
   uint32_t header_size_ = 0;
-  std::unique_ptr<base::DictionaryValue> header_;
+  std::unique_ptr<ArchiveIndex> index_;
+
+  // Read-only mapping of the whole archive, shared by all threads. Its length
+  // is the size of the archive when it was opened, see |IsMapped|.
+  base::MemoryMappedFile mapped_file_;
+
+  // Recently decompressed blocks, keyed by their offset in the archive.
+  base::Lock block_cache_lock_;
+  base::HashingMRUCache<uint64_t, scoped_refptr<base::RefCountedBytes>>
+      block_cache_;
+
+  // Lazily created copy of |index_| for other processes.
+  base::Lock shared_index_lock_;
+  base::ReadOnlySharedMemoryRegion shared_index_;
 
   // Cached external temporary files.
   base::Lock external_files_lock_;
@@ -82,6 +177,9 @@ class Archive {
                      std::unique_ptr<ScopedTemporaryFile>>
       external_files_;
 
+  // Files extracted to the persistent cache, see |ExtractToCache|.
+  std::unordered_map<base::FilePath::StringType, base::FilePath> cached_files_;
+
   DISALLOW_COPY_AND_ASSIGN(Archive);
 };
 
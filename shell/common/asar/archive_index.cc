@@ -0,0 +1,550 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/common/asar/archive_index.h"
+
+#include <algorithm>
+#include <cstring>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/files/important_file_writer.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/logging.h"
+#include "base/memory/ptr_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/threading/thread_restrictions.h"
+#include "base/values.h"
+#include "crypto/sha2.h"
+
+namespace asar {
+
+namespace {
+
+constexpr uint32_t kIndexMagic = 0x49525341;  // "ASRI"
+constexpr uint32_t kIndexVersion = 4;
+
+static_assert(sizeof(ArchiveIndex::Preamble) % alignof(ArchiveIndex::Node) == 0,
+              "The node array must be aligned.");
+
+// The only compression algorithm the header may use for now.
+const char kBrotliAlgorithm[] = "brotli";
+
+// The only integrity algorithm the header may use for now.
+const char kSHA256Algorithm[] = "SHA256";
+
+// Maximum number of links followed while resolving a single path.
+constexpr int kMaxLinkDepth = 40;
+
+#if defined(OS_WIN)
+const char kSeparators[] = "\\/";
+#else
+const char kSeparators[] = "/";
+#endif
+
+// Returns whether |preamble| describes an index built from |raw_header|.
+bool MatchesHeader(const ArchiveIndex::Preamble& preamble,
+                   base::StringPiece raw_header) {
+  if (preamble.header_size != raw_header.size())
+    return false;
+  uint8_t hash[crypto::kSHA256Length];
+  crypto::SHA256HashString(raw_header, hash, sizeof(hash));
+  return memcmp(preamble.header_hash, hash, sizeof(hash)) == 0;
+}
+
+ArchiveIndex::Preamble ReadPreamble(base::span<const uint8_t> buffer) {
+  ArchiveIndex::Preamble preamble;
+  memcpy(&preamble, buffer.data(), sizeof(preamble));
+  return preamble;
+}
+
+bool IsRangeValid(uint64_t offset, uint64_t length, uint64_t limit) {
+  return offset + length <= limit;
+}
+
+uint64_t GetBlockCount(uint32_t size, uint32_t block_size) {
+  return (static_cast<uint64_t>(size) + block_size - 1) / block_size;
+}
+
+// Flattens the JSON header breadth-first, so that the children of every
+// directory end up next to each other in the node array.
+class IndexBuilder {
+ public:
+  IndexBuilder() = default;
+
+  IndexBuilder(const IndexBuilder&) = delete;
+  IndexBuilder& operator=(const IndexBuilder&) = delete;
+
+  bool Build(const base::Value& header,
+             base::StringPiece raw_header,
+             std::vector<uint8_t>* out) {
+    if (!header.FindDictKey("files"))
+      return false;
+
+    ArchiveIndex::Node root = {};
+    root.flags = ArchiveIndex::kDirectory;
+    nodes_.push_back(root);
+
+    std::queue<std::pair<uint32_t, const base::Value*>> pending;
+    pending.emplace(0, &header);
+    while (!pending.empty()) {
+      uint32_t dir_index = pending.front().first;
+      const base::Value* files = pending.front().second->FindDictKey("files");
+      pending.pop();
+
+      std::vector<std::pair<base::StringPiece, const base::Value*>> children;
+      for (const auto& it : files->DictItems()) {
+        if (it.second.is_dict())
+          children.emplace_back(it.first, &it.second);
+      }
+      std::sort(children.begin(), children.end(),
+                [](const auto& a, const auto& b) { return a.first < b.first; });
+
+      nodes_[dir_index].first = nodes_.size();
+      nodes_[dir_index].count = children.size();
+      for (const auto& child : children) {
+        ArchiveIndex::Node node = {};
+        node.name_offset = Intern(child.first);
+        node.name_length = child.first.size();
+        if (const std::string* link = child.second->FindStringKey("link")) {
+          node.flags = ArchiveIndex::kLink;
+          node.first = Intern(*link);
+          node.count = link->size();
+        } else if (child.second->FindDictKey("files")) {
+          node.flags = ArchiveIndex::kDirectory;
+          pending.emplace(nodes_.size(), child.second);
+        } else {
+          FillFileNode(*child.second, &node);
+        }
+        nodes_.push_back(node);
+      }
+    }
+
+    ArchiveIndex::Preamble preamble = {};
+    preamble.magic = kIndexMagic;
+    preamble.version = kIndexVersion;
+    preamble.header_size = raw_header.size();
+    crypto::SHA256HashString(raw_header, preamble.header_hash,
+                             sizeof(preamble.header_hash));
+    preamble.node_count = nodes_.size();
+    preamble.block_table_size = blocks_.size();
+    preamble.hash_count = hashes_.size() / ArchiveIndex::kHashSize;
+    preamble.string_pool_size = strings_.size();
+
+    const size_t nodes_size = nodes_.size() * sizeof(ArchiveIndex::Node);
+    const size_t blocks_size = blocks_.size() * sizeof(uint32_t);
+    out->resize(sizeof(preamble) + nodes_size + blocks_size + hashes_.size() +
+                strings_.size());
+    uint8_t* cursor = out->data();
+    memcpy(cursor, &preamble, sizeof(preamble));
+    cursor += sizeof(preamble);
+    memcpy(cursor, nodes_.data(), nodes_size);
+    cursor += nodes_size;
+    memcpy(cursor, blocks_.data(), blocks_size);
+    cursor += blocks_size;
+    memcpy(cursor, hashes_.data(), hashes_.size());
+    cursor += hashes_.size();
+    memcpy(cursor, strings_.data(), strings_.size());
+    return true;
+  }
+
+ private:
+  uint32_t Intern(base::StringPiece str) {
+    auto result = interned_.emplace(std::string(str), strings_.size());
+    if (result.second)
+      strings_.append(str.data(), str.size());
+    return result.first->second;
+  }
+
+  void FillFileNode(const base::Value& value, ArchiveIndex::Node* node) {
+    absl::optional<int> size = value.FindIntKey("size");
+    if (!size) {
+      node->flags |= ArchiveIndex::kInvalid;
+      return;
+    }
+    node->size = static_cast<uint32_t>(*size);
+
+    if (value.FindBoolKey("unpacked").value_or(false)) {
+      node->flags |= ArchiveIndex::kUnpacked;
+      return;
+    }
+
+    const std::string* offset = value.FindStringKey("offset");
+    if (!offset || !base::StringToUint64(*offset, &node->offset)) {
+      node->flags |= ArchiveIndex::kInvalid;
+      return;
+    }
+
+    if (value.FindBoolKey("executable").value_or(false))
+      node->flags |= ArchiveIndex::kExecutable;
+
+    if (const base::Value* compression = value.FindDictKey("compression")) {
+      if (FillBlockTable(*compression, node))
+        node->flags |= ArchiveIndex::kCompressed;
+      else
+        node->flags |= ArchiveIndex::kInvalid;
+    }
+
+    // Empty files have nothing to verify.
+    const base::Value* integrity = value.FindDictKey("integrity");
+    if (integrity && node->size > 0) {
+      if (FillBlockHashes(*integrity, node))
+        node->flags |= ArchiveIndex::kIntegrity;
+      else
+        node->flags |= ArchiveIndex::kInvalid;
+    }
+  }
+
+  // Records the block hashes of a file, whose header entry looks like:
+  //   "integrity": {
+  //     "algorithm": "SHA256",
+  //     "hash": <hash of the whole file>,
+  //     "blockSize": <size of each block but the last>,
+  //     "blocks": [<hex encoded hash of each block>, ...]
+  //   }
+  bool FillBlockHashes(const base::Value& integrity, ArchiveIndex::Node* node) {
+    const std::string* algorithm = integrity.FindStringKey("algorithm");
+    absl::optional<int> block_size = integrity.FindIntKey("blockSize");
+    const base::Value* blocks = integrity.FindListKey("blocks");
+    if (!algorithm || *algorithm != kSHA256Algorithm || !block_size ||
+        *block_size <= 0 || !blocks)
+      return false;
+
+    base::Value::ConstListView hashes = blocks->GetList();
+    if (hashes.size() != GetBlockCount(node->size, *block_size))
+      return false;
+
+    const size_t first = hashes_.size();
+    for (const base::Value& hash : hashes) {
+      std::string bytes;
+      if (!hash.is_string() ||
+          !base::HexStringToString(hash.GetString(), &bytes) ||
+          bytes.size() != ArchiveIndex::kHashSize) {
+        hashes_.resize(first);
+        return false;
+      }
+      hashes_.append(bytes);
+    }
+
+    node->integrity_block_size = static_cast<uint32_t>(*block_size);
+    node->integrity_first = first / ArchiveIndex::kHashSize;
+    return true;
+  }
+
+  // Records the blocks of a compressed file, whose header entry looks like:
+  //   "compression": {
+  //     "algorithm": "brotli",
+  //     "blockSize": <uncompressed size of each block but the last>,
+  //     "blocks": [<compressed size of each block>, ...]
+  //   }
+  bool FillBlockTable(const base::Value& compression,
+                      ArchiveIndex::Node* node) {
+    const std::string* algorithm = compression.FindStringKey("algorithm");
+    absl::optional<int> block_size = compression.FindIntKey("blockSize");
+    const base::Value* blocks = compression.FindListKey("blocks");
+    if (!algorithm || *algorithm != kBrotliAlgorithm || !block_size ||
+        *block_size <= 0 || !blocks)
+      return false;
+
+    base::Value::ConstListView sizes = blocks->GetList();
+    if (sizes.size() != GetBlockCount(node->size, *block_size))
+      return false;
+
+    const size_t first = blocks_.size();
+    blocks_.push_back(static_cast<uint32_t>(*block_size));
+    blocks_.push_back(0);
+    uint64_t offset = 0;
+    for (const base::Value& size : sizes) {
+      offset += size.is_int() ? size.GetInt() : 0;
+      if (offset <= blocks_.back() || offset > UINT32_MAX) {
+        blocks_.resize(first);
+        return false;
+      }
+      blocks_.push_back(static_cast<uint32_t>(offset));
+    }
+
+    node->first = first;
+    node->count = sizes.size();
+    return true;
+  }
+
+  std::vector<ArchiveIndex::Node> nodes_;
+  std::vector<uint32_t> blocks_;
+  std::string hashes_;
+  std::string strings_;
+  std::unordered_map<std::string, uint32_t> interned_;
+};
+
+}  // namespace
+
+ArchiveIndex::ArchiveIndex() = default;
+
+ArchiveIndex::~ArchiveIndex() = default;
+
+// static
+std::unique_ptr<ArchiveIndex> ArchiveIndex::CreateFromHeader(
+    const base::Value& header,
+    base::StringPiece raw_header) {
+  auto index = base::WrapUnique(new ArchiveIndex);
+  IndexBuilder builder;
+  if (!builder.Build(header, raw_header, &index->owned_))
+    return nullptr;
+  index->Attach(index->owned_);
+  return index;
+}
+
+// static
+std::unique_ptr<ArchiveIndex> ArchiveIndex::CreateFromFile(
+    const base::FilePath& path,
+    base::StringPiece raw_header) {
+  auto mapped = std::make_unique<base::MemoryMappedFile>();
+  {
+    base::ThreadRestrictions::ScopedAllowIO allow_io;
+    base::File file(path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+    if (!file.IsValid() || !mapped->Initialize(std::move(file)))
+      return nullptr;
+  }
+
+  base::span<const uint8_t> data(mapped->data(), mapped->length());
+  if (!IsValid(data)) {
+    LOG(WARNING) << "Ignoring malformed asar index " << path.value();
+    return nullptr;
+  }
+
+  // The archive may have been repacked since the index was written.
+  if (!MatchesHeader(ReadPreamble(data), raw_header))
+    return nullptr;
+
+  auto index = base::WrapUnique(new ArchiveIndex);
+  index->mapped_ = std::move(mapped);
+  index->Attach(data);
+  return index;
+}
+
+// static
+std::unique_ptr<ArchiveIndex> ArchiveIndex::CreateFromSharedMemory(
+    base::ReadOnlySharedMemoryRegion region,
+    base::StringPiece raw_header) {
+  base::ReadOnlySharedMemoryMapping mapping = region.Map();
+  if (!mapping.IsValid())
+    return nullptr;
+
+  auto data = mapping.GetMemoryAsSpan<uint8_t>();
+  if (!IsValid(data)) {
+    LOG(WARNING) << "Ignoring malformed shared asar index";
+    return nullptr;
+  }
+
+  // The archive may have been replaced since the index was built.
+  if (!MatchesHeader(ReadPreamble(data), raw_header))
+    return nullptr;
+
+  auto index = base::WrapUnique(new ArchiveIndex);
+  index->shared_mapping_ = std::move(mapping);
+  index->Attach(data);
+  return index;
+}
+
+// static
+std::unique_ptr<ArchiveIndex> ArchiveIndex::CreateFromBuffer(
+    base::span<const uint8_t> buffer) {
+  auto index = base::WrapUnique(new ArchiveIndex);
+  index->owned_.assign(buffer.begin(), buffer.end());
+  if (!IsValid(index->owned_))
+    return nullptr;
+  index->Attach(index->owned_);
+  return index;
+}
+
+bool ArchiveIndex::WriteToFile(const base::FilePath& path) const {
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  return base::ImportantFileWriter::WriteFileAtomically(
+      path, base::StringPiece(reinterpret_cast<const char*>(data_.data()),
+                              data_.size()));
+}
+
+// static
+bool ArchiveIndex::IsValid(base::span<const uint8_t> buffer) {
+  if (buffer.size() < sizeof(Preamble) ||
+      reinterpret_cast<uintptr_t>(buffer.data()) % alignof(Node) != 0)
+    return false;
+
+  Preamble preamble = ReadPreamble(buffer);
+  if (preamble.magic != kIndexMagic || preamble.version != kIndexVersion ||
+      preamble.node_count == 0)
+    return false;
+
+  const uint64_t nodes_size =
+      static_cast<uint64_t>(preamble.node_count) * sizeof(Node);
+  const uint64_t blocks_size =
+      static_cast<uint64_t>(preamble.block_table_size) * sizeof(uint32_t);
+  const uint64_t hashes_size =
+      static_cast<uint64_t>(preamble.hash_count) * kHashSize;
+  if (sizeof(Preamble) + nodes_size + blocks_size + hashes_size +
+          preamble.string_pool_size !=
+      buffer.size())
+    return false;
+
+  const Node* nodes =
+      reinterpret_cast<const Node*>(buffer.data() + sizeof(Preamble));
+  const uint32_t* blocks = reinterpret_cast<const uint32_t*>(
+      buffer.data() + sizeof(Preamble) + nodes_size);
+  if (!(nodes[0].flags & kDirectory))
+    return false;
+
+  for (uint32_t i = 0; i < preamble.node_count; ++i) {
+    const Node& node = nodes[i];
+    if (!IsRangeValid(node.name_offset, node.name_length,
+                      preamble.string_pool_size))
+      return false;
+    if (node.flags & kDirectory) {
+      // Children always come after their parent, which rules out cycles.
+      if (node.count != 0 && (node.first <= i || !IsRangeValid(
+                                                     node.first, node.count,
+                                                     preamble.node_count)))
+        return false;
+    } else if (node.flags & kLink) {
+      if (!IsRangeValid(node.first, node.count, preamble.string_pool_size))
+        return false;
+    } else if (node.flags & kCompressed) {
+      // The block size, followed by strictly increasing offsets starting at 0.
+      if (!IsRangeValid(node.first, static_cast<uint64_t>(node.count) + 2,
+                        preamble.block_table_size))
+        return false;
+      const uint32_t* table = blocks + node.first;
+      if (table[0] == 0 || GetBlockCount(node.size, table[0]) != node.count ||
+          table[1] != 0)
+        return false;
+      for (uint32_t block = 1; block <= node.count; ++block) {
+        if (table[block + 1] <= table[block])
+          return false;
+      }
+    }
+
+    if ((node.flags & kIntegrity) &&
+        (node.flags & (kDirectory | kLink) || node.integrity_block_size == 0 ||
+         !IsRangeValid(node.integrity_first,
+                       GetBlockCount(node.size, node.integrity_block_size),
+                       preamble.hash_count)))
+      return false;
+  }
+  return true;
+}
+
+void ArchiveIndex::Attach(base::span<const uint8_t> data) {
+  Preamble preamble = ReadPreamble(data);
+  const size_t nodes_size = preamble.node_count * sizeof(Node);
+  const size_t blocks_size = preamble.block_table_size * sizeof(uint32_t);
+  const size_t hashes_size = preamble.hash_count * kHashSize;
+  data_ = data;
+  nodes_ = base::make_span(
+      reinterpret_cast<const Node*>(data.data() + sizeof(Preamble)),
+      preamble.node_count);
+  blocks_ = base::make_span(reinterpret_cast<const uint32_t*>(
+                                data.data() + sizeof(Preamble) + nodes_size),
+                            preamble.block_table_size);
+  hashes_ = data.subspan(sizeof(Preamble) + nodes_size + blocks_size,
+                         hashes_size);
+  strings_ = base::StringPiece(
+      reinterpret_cast<const char*>(data.data() + sizeof(Preamble) +
+                                    nodes_size + blocks_size + hashes_size),
+      preamble.string_pool_size);
+}
+
+const ArchiveIndex::Node* ArchiveIndex::Lookup(base::StringPiece path) const {
+  return LookupWithDepth(path, 0);
+}
+
+const ArchiveIndex::Node* ArchiveIndex::ResolveLink(const Node* node) const {
+  return ResolveLinkWithDepth(node, 0);
+}
+
+base::StringPiece ArchiveIndex::GetName(const Node& node) const {
+  return strings_.substr(node.name_offset, node.name_length);
+}
+
+base::StringPiece ArchiveIndex::GetLinkTarget(const Node& node) const {
+  DCHECK(node.flags & kLink);
+  return strings_.substr(node.first, node.count);
+}
+
+base::span<const ArchiveIndex::Node> ArchiveIndex::GetChildren(
+    const Node& node) const {
+  if (!(node.flags & kDirectory))
+    return {};
+  return nodes_.subspan(node.first, node.count);
+}
+
+uint32_t ArchiveIndex::GetBlockSize(const Node& node) const {
+  DCHECK(node.flags & kCompressed);
+  return blocks_[node.first];
+}
+
+base::span<const uint32_t> ArchiveIndex::GetBlockOffsets(
+    const Node& node) const {
+  DCHECK(node.flags & kCompressed);
+  return blocks_.subspan(node.first + 1, node.count + 1);
+}
+
+base::span<const uint8_t> ArchiveIndex::GetBlockHashes(
+    const Node& node) const {
+  DCHECK(node.flags & kIntegrity);
+  return hashes_.subspan(
+      static_cast<size_t>(node.integrity_first) * kHashSize,
+      GetBlockCount(node.size, node.integrity_block_size) * kHashSize);
+}
+
+const ArchiveIndex::Node* ArchiveIndex::LookupWithDepth(base::StringPiece path,
+                                                        int depth) const {
+  // Paths are relative to the root, and "dir/" names the same node as "dir".
+  path = base::TrimString(path, kSeparators, base::TRIM_ALL);
+  const Node* node = root();
+  if (path.empty())
+    return node;
+  while (true) {
+    size_t delimiter_position = path.find_first_of(kSeparators);
+    node = FindChild(node, path.substr(0, delimiter_position), depth);
+    if (!node || delimiter_position == base::StringPiece::npos)
+      return node;
+    path.remove_prefix(delimiter_position + 1);
+  }
+}
+
+const ArchiveIndex::Node* ArchiveIndex::ResolveLinkWithDepth(const Node* node,
+                                                             int depth) const {
+  while (node && (node->flags & kLink)) {
+    if (++depth > kMaxLinkDepth)
+      return nullptr;
+    node = LookupWithDepth(GetLinkTarget(*node), depth);
+  }
+  return node;
+}
+
+const ArchiveIndex::Node* ArchiveIndex::FindChild(const Node* dir,
+                                                  base::StringPiece name,
+                                                  int depth) const {
+  // No entry has an empty name, e.g. in "dir//file".
+  if (name.empty())
+    return nullptr;
+
+  dir = ResolveLinkWithDepth(dir, depth);
+  if (!dir)
+    return nullptr;
+
+  base::span<const Node> children = GetChildren(*dir);
+  auto it = std::lower_bound(children.begin(), children.end(), name,
+                             [this](const Node& node, base::StringPiece name) {
+                               return GetName(node) < name;
+                             });
+  if (it == children.end() || GetName(*it) != name)
+    return nullptr;
+  return &*it;
+}
+
+}  // namespace asar
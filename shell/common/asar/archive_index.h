@@ -0,0 +1,174 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_COMMON_ASAR_ARCHIVE_INDEX_H_
+#define SHELL_COMMON_ASAR_ARCHIVE_INDEX_H_
+
+#include <memory>
+#include <vector>
+
+#include "base/containers/span.h"
+#include "base/memory/read_only_shared_memory_region.h"
+#include "base/strings/string_piece.h"
+
+namespace base {
+class FilePath;
+class MemoryMappedFile;
+class Value;
+}  // namespace base
+
+namespace asar {
+
+// A compact, read-only index of an asar header.
+//
+// The whole index lives in one contiguous, position-independent buffer:
+//
+//   | Preamble | Node[node_count] | uint32_t[block_table_size] |
+//   | SHA-256[hash_count] | string pool[string_pool_size] |
+//
+// Names and link targets are interned in the string pool, the block layout
+// of compressed files lives in the block table, and the integrity hashes of
+// file blocks are stored back to back after it. The root is node 0,
+// and the children of every directory are stored contiguously in the node
+// array sorted by name, so a path lookup is a binary search per component and
+// never allocates. Because the buffer contains no pointers it can be written
+// to disk and memory-mapped back, or handed to other processes as is.
+class ArchiveIndex {
+ public:
+  enum Flags : uint32_t {
+    kDirectory = 1 << 0,
+    kLink = 1 << 1,
+    kUnpacked = 1 << 2,
+    kExecutable = 1 << 3,
+    // The header entry is missing required fields.
+    kInvalid = 1 << 4,
+    // The file is stored as independently compressed blocks.
+    kCompressed = 1 << 5,
+    // The header carries hashes of the file's blocks.
+    kIntegrity = 1 << 6,
+  };
+
+  // Size of a SHA-256 hash.
+  static constexpr size_t kHashSize = 32;
+
+  struct Preamble {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t node_count;
+    uint32_t block_table_size;
+    uint32_t hash_count;
+    uint32_t string_pool_size;
+    // Size and SHA-256 hash of the JSON header the index was built from.
+    uint32_t header_size;
+    uint32_t reserved;
+    uint8_t header_hash[kHashSize];
+  };
+
+  struct Node {
+    uint32_t name_offset;
+    uint32_t name_length;
+    uint32_t flags;
+    uint32_t size;
+    // Offset of the file's content, relative to the end of the header.
+    uint64_t offset;
+    // Directories: the range of children in the node array.
+    // Links: the location of the target path in the string pool.
+    // Compressed files: the location of the block size in the block table,
+    // followed by |count| + 1 offsets of the blocks relative to |offset|.
+    uint32_t first;
+    uint32_t count;
+    // Files with integrity: the size of the hashed blocks of the uncompressed
+    // content, and the index of the first block's hash.
+    uint32_t integrity_block_size;
+    uint32_t integrity_first;
+  };
+
+  ~ArchiveIndex();
+
+  ArchiveIndex(const ArchiveIndex&) = delete;
+  ArchiveIndex& operator=(const ArchiveIndex&) = delete;
+
+  // Builds the index from the parsed JSON |header|.
+  static std::unique_ptr<ArchiveIndex> CreateFromHeader(
+      const base::Value& header,
+      base::StringPiece raw_header);
+
+  // Maps a serialized index from |path|, returning null if it does not exist,
+  // is malformed or was not built from |raw_header|.
+  static std::unique_ptr<ArchiveIndex> CreateFromFile(
+      const base::FilePath& path,
+      base::StringPiece raw_header);
+
+  // Maps and validates a serialized index shared by another process,
+  // returning null if it is malformed or was not built from |raw_header|.
+  static std::unique_ptr<ArchiveIndex> CreateFromSharedMemory(
+      base::ReadOnlySharedMemoryRegion region,
+      base::StringPiece raw_header);
+
+  // Copies and validates a serialized index.
+  static std::unique_ptr<ArchiveIndex> CreateFromBuffer(
+      base::span<const uint8_t> buffer);
+
+  // Writes the serialized index to |path|, replacing any previous file
+  // atomically so that a reader never maps a partially written one.
+  bool WriteToFile(const base::FilePath& path) const;
+
+  // Returns whether |buffer| holds a well-formed index.
+  static bool IsValid(base::span<const uint8_t> buffer);
+
+  // Returns the node at |path|, or null. Links in intermediate components are
+  // followed, but the last component is returned as is.
+  const Node* Lookup(base::StringPiece path) const;
+
+  // Follows |node| until it is no longer a link. Returns null for dangling or
+  // cyclic links.
+  const Node* ResolveLink(const Node* node) const;
+
+  base::StringPiece GetName(const Node& node) const;
+  base::StringPiece GetLinkTarget(const Node& node) const;
+  base::span<const Node> GetChildren(const Node& node) const;
+
+  // Returns the uncompressed size of all but the last block of a compressed
+  // file, and the offsets of its blocks. The compressed size of block i is
+  // offsets[i + 1] - offsets[i].
+  uint32_t GetBlockSize(const Node& node) const;
+  base::span<const uint32_t> GetBlockOffsets(const Node& node) const;
+
+  // Returns the concatenated SHA-256 hashes of the blocks of a file with
+  // integrity.
+  base::span<const uint8_t> GetBlockHashes(const Node& node) const;
+
+  const Node* root() const { return nodes_.data(); }
+
+  // The serialized form of the index.
+  base::span<const uint8_t> data() const { return data_; }
+
+ private:
+  ArchiveIndex();
+
+  // Points the accessors at |data|, which must outlive this object and have
+  // passed IsValid().
+  void Attach(base::span<const uint8_t> data);
+
+  const Node* LookupWithDepth(base::StringPiece path, int depth) const;
+  const Node* ResolveLinkWithDepth(const Node* node, int depth) const;
+  const Node* FindChild(const Node* dir,
+                        base::StringPiece name,
+                        int depth) const;
+
+  // Exactly one of these backs |data_|.
+  std::vector<uint8_t> owned_;
+  std::unique_ptr<base::MemoryMappedFile> mapped_;
+  base::ReadOnlySharedMemoryMapping shared_mapping_;
+
+  base::span<const uint8_t> data_;
+  base::span<const Node> nodes_;
+  base::span<const uint32_t> blocks_;
+  base::span<const uint8_t> hashes_;
+  base::StringPiece strings_;
+};
+
+}  // namespace asar
+
+#endif  // SHELL_COMMON_ASAR_ARCHIVE_INDEX_H_
@@ -8,6 +8,7 @@
 #include <string>
 #include <utility>
 
+#include "base/callback.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
 #include "base/lazy_instance.h"
@@ -54,24 +55,50 @@ base::Lock& GetArchiveCacheLock() {
   return *lock;
 }
 
+ArchiveIndexProvider& GetArchiveIndexProvider() {
+  static base::NoDestructor<ArchiveIndexProvider> s_provider;
+  return *s_provider;
+}
+
 std::shared_ptr<Archive> GetOrCreateAsarArchive(const base::FilePath& path) {
-  base::AutoLock auto_lock(GetArchiveCacheLock());
-  ArchiveMap& map = GetArchiveCache();
+  ArchiveIndexProvider provider;
+  {
+    base::AutoLock auto_lock(GetArchiveCacheLock());
+    ArchiveMap& map = GetArchiveCache();
 
-  // if we have it, return it
-  const auto lower = map.lower_bound(path);
-  if (lower != std::end(map) && !map.key_comp()(path, lower->first))
-    return lower->second;
+    // if we have it, or know it can't be opened, return it
+    auto it = map.find(path);
+    if (it != map.end())
+      return it->second;
 
-  // if we can create it, return it
-  auto archive = std::make_shared<Archive>(path);
-  if (archive->Init()) {
-    base::TryEmplace(map, lower, path, archive);
-    return archive;
+    provider = GetArchiveIndexProvider();
+  }
+
+  // Paths that don't exist are common when probing for modules, and must not
+  // cost a round trip to the browser process. They are not cached, as the
+  // archive may still be written later.
+  {
+    base::ThreadRestrictions::ScopedAllowIO allow_io;
+    if (!base::PathExists(path))
+      return nullptr;
   }
 
-  // didn't have it, couldn't create it
-  return nullptr;
+  // if we can create it, return it. The provider may block on the browser
+  // process, so the lock is not held while creating the archive.
+  base::ReadOnlySharedMemoryRegion index;
+  if (provider)
+    index = provider.Run(path);
+  auto archive = std::make_shared<Archive>(path);
+  // Archives that exist but can't be read are remembered as such, so that
+  // every access does not open, read and ask the browser process for them
+  // again.
+  if (!archive->InitWithSharedIndex(std::move(index)))
+    archive.reset();
+
+  // Another thread may have created it in the meantime, so keep theirs.
+  base::AutoLock auto_lock(GetArchiveCacheLock());
+  return base::TryEmplace(GetArchiveCache(), path, std::move(archive))
+      .first->second;
 }
 
 void ClearArchives() {
@@ -81,6 +108,25 @@ void ClearArchives() {
   map.clear();
 }
 
+base::ReadOnlySharedMemoryRegion GetSharedArchiveIndex(
+    const base::FilePath& path) {
+  std::shared_ptr<Archive> archive;
+  {
+    base::AutoLock auto_lock(GetArchiveCacheLock());
+    ArchiveMap& map = GetArchiveCache();
+    auto it = map.find(path);
+    if (it == map.end() || !it->second)
+      return base::ReadOnlySharedMemoryRegion();
+    archive = it->second;
+  }
+  return archive->DuplicateSharedIndex();
+}
+
+void SetArchiveIndexProvider(ArchiveIndexProvider provider) {
+  base::AutoLock auto_lock(GetArchiveCacheLock());
+  GetArchiveIndexProvider() = std::move(provider);
+}
+
 bool GetAsarArchivePath(const base::FilePath& full_path,
                         base::FilePath* asar_path,
                         base::FilePath* relative_path,
@@ -125,14 +171,31 @@ bool ReadFileToString(const base::FilePath& path, std::string* contents) {
     return base::ReadFileToString(real_path, contents);
   }
 
-  base::File src(asar_path, base::File::FLAG_OPEN | base::File::FLAG_READ);
-  if (!src.IsValid())
+  contents->resize(info.size);
+  return archive->ReadFile(
+      info, 0,
+      base::make_span(reinterpret_cast<uint8_t*>(&(*contents)[0]),
+                      contents->size()));
+}
+
+bool GetPackedFileContents(const base::FilePath& path,
+                           std::shared_ptr<Archive>* archive,
+                           base::span<const uint8_t>* contents) {
+  base::FilePath asar_path, relative_path;
+  if (!GetAsarArchivePath(path, &asar_path, &relative_path))
+    return false;
+
+  std::shared_ptr<Archive> result = GetOrCreateAsarArchive(asar_path);
+  if (!result)
     return false;
 
-  contents->resize(info.size);
-  return static_cast<int>(info.size) ==
-         src.Read(info.offset, const_cast<char*>(contents->data()),
-                  contents->size());
+  Archive::FileInfo info;
+  if (!result->GetFileInfo(relative_path, &info) ||
+      !result->GetFileContents(info, contents))
+    return false;
+
+  *archive = std::move(result);
+  return true;
 }
 
 }  // namespace asar
@@ -8,6 +8,10 @@
 #include <memory>
 #include <string>
 
+#include "base/callback_forward.h"
+#include "base/containers/span.h"
+#include "base/memory/read_only_shared_memory_region.h"
+
 namespace base {
 class FilePath;
 }
@@ -16,12 +20,28 @@ namespace asar {
 
 class Archive;
 
-// Gets or creates and caches a new Archive from the path.
+// Gets or creates and caches a new Archive from the path. Returns null when
+// the archive doesn't exist or can't be read, and the latter is cached too.
 std::shared_ptr<Archive> GetOrCreateAsarArchive(const base::FilePath& path);
 
 // Destroy cached Archive objects.
 void ClearArchives();
 
+// Returns a read-only copy of the index of an archive this process has already
+// opened, or an invalid region.
+base::ReadOnlySharedMemoryRegion GetSharedArchiveIndex(
+    const base::FilePath& path);
+
+// Supplies archive indexes built by another process, so that newly opened
+// archives can skip parsing their header. The header is still read and
+// hashed to make sure the index matches the archive on disk. The provider is
+// asked for an index the first time an existing archive is opened, may be
+// called from any thread and returns an invalid region when no index is
+// available.
+using ArchiveIndexProvider = base::RepeatingCallback<
+    base::ReadOnlySharedMemoryRegion(const base::FilePath& path)>;
+void SetArchiveIndexProvider(ArchiveIndexProvider provider);
+
 // Separates the path to Archive out.
 bool GetAsarArchivePath(const base::FilePath& full_path,
                         base::FilePath* asar_path,
@@ -31,6 +51,13 @@ bool GetAsarArchivePath(const base::FilePath& full_path,
 // Same with base::ReadFileToString but supports asar Archive.
 bool ReadFileToString(const base::FilePath& path, std::string* contents);
 
+// Points |contents| at the bytes of the packed asar file |path| inside the
+// archive's mapping, without copying. |archive| keeps the mapping alive.
+// Returns false if |path| is not a packed file or the archive is not mapped.
+bool GetPackedFileContents(const base::FilePath& path,
+                           std::shared_ptr<Archive>* archive,
+                           base::span<const uint8_t>* contents);
+
 }  // namespace asar
 
 #endif  // SHELL_COMMON_ASAR_ASAR_UTIL_H_
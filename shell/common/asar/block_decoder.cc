@@ -0,0 +1,94 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/common/asar/block_decoder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/memory/ref_counted.h"
+#include "base/system/sys_info.h"
+#include "base/task/thread_pool.h"
+#include "base/threading/platform_thread.h"
+#include "third_party/brotli/include/brotli/decode.h"
+
+namespace asar {
+
+namespace {
+
+// Hands out block indices to whichever thread asks first, so a busy thread
+// pool never leaves the caller waiting for work it could have done itself.
+class ParallelDecode : public base::RefCountedThreadSafe<ParallelDecode> {
+ public:
+  ParallelDecode(size_t count, base::RepeatingCallback<bool(size_t)> decode)
+      : count_(count), remaining_(count), decode_(std::move(decode)) {}
+
+  ParallelDecode(const ParallelDecode&) = delete;
+  ParallelDecode& operator=(const ParallelDecode&) = delete;
+
+  void Run() {
+    size_t index;
+    while ((index = next_.fetch_add(1)) < count_) {
+      if (!decode_.Run(index))
+        failed_ = true;
+      remaining_.fetch_sub(1);
+    }
+  }
+
+  // Called by the caller once Run() has returned, at which point every block
+  // has been claimed. Helpers only still hold the blocks they are decoding, so
+  // this waits for a single block's decode time at most. Yielding instead of
+  // blocking on an event keeps it usable on threads that disallow waiting.
+  bool Wait() {
+    while (remaining_.load() != 0)
+      base::PlatformThread::YieldCurrentThread();
+    return !failed_;
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<ParallelDecode>;
+  ~ParallelDecode() = default;
+
+  const size_t count_;
+  std::atomic<size_t> next_{0};
+  std::atomic<size_t> remaining_;
+  std::atomic<bool> failed_{false};
+  base::RepeatingCallback<bool(size_t)> decode_;
+};
+
+}  // namespace
+
+bool DecompressBlock(base::span<const uint8_t> block,
+                     base::span<uint8_t> output) {
+  size_t decoded_size = output.size();
+  if (BrotliDecoderDecompress(block.size(), block.data(), &decoded_size,
+                              output.data()) != BROTLI_DECODER_RESULT_SUCCESS)
+    return false;
+  return decoded_size == output.size();
+}
+
+bool DecodeBlocksInParallel(size_t count,
+                            base::RepeatingCallback<bool(size_t)> decode) {
+  if (count == 0)
+    return true;
+
+  auto parallel_decode =
+      base::MakeRefCounted<ParallelDecode>(count, std::move(decode));
+  const size_t helpers = std::min<size_t>(
+      count - 1, std::max(base::SysInfo::NumberOfProcessors() - 1, 0));
+  for (size_t i = 0; i < helpers; ++i) {
+    base::ThreadPool::PostTask(
+        FROM_HERE,
+        {base::MayBlock(), base::TaskPriority::USER_BLOCKING,
+         base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN},
+        base::BindOnce(&ParallelDecode::Run, parallel_decode));
+  }
+
+  parallel_decode->Run();
+  return parallel_decode->Wait();
+}
+
+}  // namespace asar
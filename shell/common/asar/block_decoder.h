@@ -0,0 +1,27 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_COMMON_ASAR_BLOCK_DECODER_H_
+#define SHELL_COMMON_ASAR_BLOCK_DECODER_H_
+
+#include "base/callback.h"
+#include "base/containers/span.h"
+
+namespace asar {
+
+// Decompresses a brotli |block|, which must fill |output| exactly.
+bool DecompressBlock(base::span<const uint8_t> block,
+                     base::span<uint8_t> output);
+
+// Runs |decode| for every index in [0, count), spreading the calls over the
+// thread pool while the calling thread also takes part. Returns once all calls
+// have returned, and returns whether all of them succeeded. Must only be called
+// on threads with a task runner, as the thread pool may not be running
+// otherwise.
+bool DecodeBlocksInParallel(size_t count,
+                            base::RepeatingCallback<bool(size_t)> decode);
+
+}  // namespace asar
+
+#endif  // SHELL_COMMON_ASAR_BLOCK_DECODER_H_
@@ -0,0 +1,179 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/common/asar/extraction_cache.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "base/command_line.h"
+#include "base/files/file_enumerator.h"
+#include "base/files/file_util.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/path_service.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/threading/thread_restrictions.h"
+#include "base/time/time.h"
+#include "crypto/sha2.h"
+#include "shell/common/electron_paths.h"
+#include "shell/common/options_switches.h"
+
+namespace asar {
+
+namespace {
+
+const base::FilePath::CharType kCacheDirName[] = FILE_PATH_LITERAL("AsarCache");
+
+// Entries that were not used for this long are removed.
+constexpr base::TimeDelta kMaxEntryAge = base::TimeDelta::FromDays(30);
+
+// When the cache grows beyond this size, the least recently used entries are
+// removed, except for those used within |kMinEvictionAge| which another
+// running instance may still hand out.
+constexpr int64_t kMaxCacheSize = 256 * 1024 * 1024;
+constexpr base::TimeDelta kMinEvictionAge = base::TimeDelta::FromDays(1);
+
+using Digest = std::array<uint8_t, crypto::kSHA256Length>;
+
+// Returns whether |path| holds exactly |contents|. The copy is compared in
+// full on every use, since anything able to write to the cache directory
+// could have replaced it, including its size and timestamps.
+bool IsIntactCopy(const base::FilePath& path,
+                  base::span<const uint8_t> contents) {
+  base::File::Info info;
+  if (!base::GetFileInfo(path, &info) || info.is_directory ||
+      static_cast<uint64_t>(info.size) != contents.size())
+    return false;
+
+  base::MemoryMappedFile file;
+  if (!file.Initialize(path) || file.length() != contents.size())
+    return false;
+  return memcmp(file.data(), contents.data(), contents.size()) == 0;
+}
+
+// Removes stale entries from |cache_dir| and keeps its size bounded. Entry
+// directories are touched whenever they are used, so their modification time
+// is their last use. |in_use| is never removed.
+void PruneCache(const base::FilePath& cache_dir, const base::FilePath& in_use) {
+  struct Entry {
+    base::FilePath path;
+    base::Time last_used;
+    int64_t size;
+  };
+  std::vector<Entry> entries;
+  int64_t total_size = 0;
+  const base::Time now = base::Time::Now();
+
+  base::FileEnumerator enumerator(cache_dir, false /* recursive */,
+                                  base::FileEnumerator::DIRECTORIES);
+  for (base::FilePath path = enumerator.Next(); !path.empty();
+       path = enumerator.Next()) {
+    if (path == in_use)
+      continue;
+    base::Time last_used = enumerator.GetInfo().GetLastModifiedTime();
+    if (now - last_used > kMaxEntryAge) {
+      base::DeletePathRecursively(path);
+      continue;
+    }
+    int64_t size = base::ComputeDirectorySize(path);
+    total_size += size;
+    entries.push_back({path, last_used, size});
+  }
+  total_size += base::ComputeDirectorySize(in_use);
+  if (total_size <= kMaxCacheSize)
+    return;
+
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry& a, const Entry& b) {
+              return a.last_used < b.last_used;
+            });
+  for (const Entry& entry : entries) {
+    if (total_size <= kMaxCacheSize || now - entry.last_used < kMinEvictionAge)
+      break;
+    if (base::DeletePathRecursively(entry.path))
+      total_size -= entry.size;
+  }
+}
+
+}  // namespace
+
+ExtractMode GetExtractMode() {
+  static const ExtractMode mode = [] {
+    std::string value =
+        base::CommandLine::ForCurrentProcess()->GetSwitchValueASCII(
+            electron::switches::kAsarExtractMode);
+#if defined(OS_LINUX)
+    if (value == "memory")
+      return ExtractMode::kMemory;
+#endif
+    if (value == "cache")
+      return ExtractMode::kCache;
+    return ExtractMode::kTemporaryFile;
+  }();
+  return mode;
+}
+
+bool ExtractToCache(base::span<const uint8_t> contents,
+                    const base::FilePath& name,
+                    bool executable,
+                    base::FilePath* out) {
+  // Empty files can't be mapped for verification, and are cheap to extract.
+  if (contents.empty())
+    return false;
+
+  base::FilePath cache_dir;
+  if (!base::PathService::Get(electron::DIR_USER_CACHE, &cache_dir))
+    return false;
+
+  const Digest digest = crypto::SHA256Hash(contents);
+  cache_dir = cache_dir.Append(kCacheDirName);
+  const base::FilePath dir =
+      cache_dir.AppendASCII(base::HexEncode(digest.data(), digest.size()));
+  const base::FilePath path = dir.Append(name);
+
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+
+  static std::atomic<bool> pruned(false);
+  if (!pruned.exchange(true))
+    PruneCache(cache_dir, dir);
+
+  const base::Time now = base::Time::Now();
+  if (IsIntactCopy(path, contents)) {
+    base::TouchFile(dir, now, now);
+    *out = path;
+    return true;
+  }
+
+  base::FilePath temp_path;
+  if (!base::CreateDirectory(dir) ||
+      !base::CreateTemporaryFileInDir(dir, &temp_path))
+    return false;
+
+  if (!base::WriteFile(temp_path, contents)) {
+    base::DeleteFile(temp_path);
+    return false;
+  }
+
+#if defined(OS_POSIX)
+  if (executable)
+    base::SetPosixFilePermissions(temp_path, 0755);
+#endif
+
+  // Other processes may be extracting the same file concurrently, which is
+  // fine since every copy has the same content.
+  if (!base::ReplaceFile(temp_path, path, nullptr)) {
+    base::DeleteFile(temp_path);
+    return false;
+  }
+  base::TouchFile(dir, now, now);
+
+  *out = path;
+  return true;
+}
+
+}  // namespace asar
@@ -0,0 +1,36 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_COMMON_ASAR_EXTRACTION_CACHE_H_
+#define SHELL_COMMON_ASAR_EXTRACTION_CACHE_H_
+
+#include "base/containers/span.h"
+#include "base/files/file_path.h"
+
+namespace asar {
+
+// How |Archive::CopyFileOut| materializes packed files.
+enum class ExtractMode {
+  // A temporary file that is deleted when the archive is destroyed.
+  kTemporaryFile,
+  // An anonymous in-memory file (Linux only).
+  kMemory,
+  // A content-addressed file that is kept and reused across launches.
+  kCache,
+};
+
+// Returns the mode selected with --asar-extract-mode for this process.
+ExtractMode GetExtractMode();
+
+// Returns the path of a file with |contents| named |name| in the persistent
+// extraction cache, writing it only if no intact copy exists yet. The file is
+// made executable if |executable| is set.
+bool ExtractToCache(base::span<const uint8_t> contents,
+                    const base::FilePath& name,
+                    bool executable,
+                    base::FilePath* out);
+
+}  // namespace asar
+
+#endif  // SHELL_COMMON_ASAR_EXTRACTION_CACHE_H_
@@ -4,16 +4,41 @@
 
 #include "shell/common/asar/scoped_temporary_file.h"
 
-#include <vector>
+#include <utility>
 
+#include "base/files/file.h"
 #include "base/files/file_util.h"
 #include "base/threading/thread_restrictions.h"
 
+#if defined(OS_LINUX)
+#include <fcntl.h>
+#include <linux/memfd.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "base/posix/eintr_wrapper.h"
+#include "base/process/process_handle.h"
+#include "base/strings/stringprintf.h"
+
+#if !defined(F_ADD_SEALS)
+#define F_ADD_SEALS 1033
+#define F_SEAL_SEAL 0x0001
+#define F_SEAL_SHRINK 0x0002
+#define F_SEAL_GROW 0x0004
+#define F_SEAL_WRITE 0x0008
+#endif
+#endif
+
 namespace asar {
 
 ScopedTemporaryFile::ScopedTemporaryFile() = default;
 
 ScopedTemporaryFile::~ScopedTemporaryFile() {
+#if defined(OS_LINUX)
+  // In-memory files go away with their descriptor.
+  if (memfd_.is_valid())
+    return;
+#endif
   if (!path_.empty()) {
     base::ThreadRestrictions::ScopedAllowIO allow_io;
     // On Windows it is very likely the file is already in use (because it is
@@ -48,27 +73,48 @@ bool ScopedTemporaryFile::Init(const base::FilePath::StringType& ext) {
   return true;
 }
 
-bool ScopedTemporaryFile::InitFromFile(base::File* src,
-                                       const base::FilePath::StringType& ext,
-                                       uint64_t offset,
-                                       uint64_t size) {
-  if (!src->IsValid())
+bool ScopedTemporaryFile::InitFromContents(
+    const base::FilePath::StringType& ext,
+    base::span<const uint8_t> contents) {
+  if (!Init(ext))
     return false;
 
-  if (!Init(ext))
+  base::File dest(path_, base::File::FLAG_OPEN | base::File::FLAG_WRITE);
+  if (!dest.IsValid())
     return false;
 
-  std::vector<char> buf(size);
-  int len = src->Read(offset, buf.data(), buf.size());
-  if (len != static_cast<int>(size))
+  return dest.WriteAtCurrentPos(reinterpret_cast<const char*>(contents.data()),
+                                contents.size()) ==
+         static_cast<int>(contents.size());
+}
+
+#if defined(OS_LINUX)
+bool ScopedTemporaryFile::InitInMemory(const base::FilePath::StringType& name,
+                                       base::span<const uint8_t> contents) {
+  if (!path_.empty())
+    return true;
+
+  base::ScopedFD fd(static_cast<int>(syscall(
+      __NR_memfd_create, name.c_str(), MFD_CLOEXEC | MFD_ALLOW_SEALING)));
+  if (!fd.is_valid())
     return false;
 
-  base::File dest(path_, base::File::FLAG_OPEN | base::File::FLAG_WRITE);
-  if (!dest.IsValid())
+  if (!base::WriteFileDescriptor(fd.get(), contents))
     return false;
 
-  return dest.WriteAtCurrentPos(buf.data(), buf.size()) ==
-         static_cast<int>(size);
+  // Nobody gets to modify the extracted file after this point.
+  if (HANDLE_EINTR(fcntl(fd.get(), F_ADD_SEALS,
+                         F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE |
+                             F_SEAL_SEAL)) != 0)
+    return false;
+
+  // Use the pid instead of "self" so that the path also resolves in child
+  // processes, for example when the file is an executable.
+  path_ = base::FilePath(base::StringPrintf(
+      "/proc/%d/fd/%d", base::GetCurrentProcId(), fd.get()));
+  memfd_ = std::move(fd);
+  return true;
 }
+#endif
 
 }  // namespace asar
@@ -5,11 +5,10 @@
 #ifndef SHELL_COMMON_ASAR_SCOPED_TEMPORARY_FILE_H_
 #define SHELL_COMMON_ASAR_SCOPED_TEMPORARY_FILE_H_
 
+#include "base/containers/span.h"
 #include "base/files/file_path.h"
-
-namespace base {
-class File;
-}
+#include "base/files/scoped_file.h"
+#include "build/build_config.h"
 
 namespace asar {
 
@@ -27,16 +26,27 @@ class ScopedTemporaryFile {
   // Init an empty temporary file with a certain extension.
   bool Init(const base::FilePath::StringType& ext);
 
-  // Init an temporary file and fill it with content of |path|.
-  bool InitFromFile(base::File* src,
-                    const base::FilePath::StringType& ext,
-                    uint64_t offset,
-                    uint64_t size);
+  // Init an temporary file and fill it with |contents|.
+  bool InitFromContents(const base::FilePath::StringType& ext,
+                        base::span<const uint8_t> contents);
+
+#if defined(OS_LINUX)
+  // Init an anonymous in-memory file filled with |contents|. The file never
+  // touches the disk and is reachable through a /proc/<pid>/fd path for as
+  // long as this object lives.
+  bool InitInMemory(const base::FilePath::StringType& name,
+                    base::span<const uint8_t> contents);
+#endif
 
   base::FilePath path() const { return path_; }
 
  private:
   base::FilePath path_;
+
+#if defined(OS_LINUX)
+  // Set for in-memory files, which are released by closing it.
+  base::ScopedFD memfd_;
+#endif
 };
 
 }  // namespace asar
@@ -25,6 +25,7 @@
 #include "content/public/common/content_paths.h"
 #include "electron/buildflags/buildflags.h"
 #include "shell/browser/api/electron_api_app.h"
+#include "shell/browser/microtasks_runner.h"
 #include "shell/common/api/electron_bindings.h"
 #include "shell/common/electron_command_line.h"
 #include "shell/common/gin_converters/file_path_converter.h"
@@ -59,6 +60,7 @@
   V(electron_browser_protocol)           \
   V(electron_browser_printing)           \
   V(electron_browser_session)            \
+  V(electron_browser_shared_values)      \
   V(electron_browser_system_preferences) \
   V(electron_browser_base_window)        \
   V(electron_browser_tray)               \
@@ -302,17 +304,20 @@ NodeBindings::NodeBindings(BrowserEnvironment browser_env)
 }
 
 NodeBindings::~NodeBindings() {
-  // Quit the embed thread.
-  embed_closed_ = true;
-  uv_sem_post(&embed_sem_);
+  if (embed_thread_started_) {
+    // Quit the embed thread.
+    embed_closed_ = true;
+    uv_sem_post(&embed_sem_);
 
-  WakeupEmbedThread();
+    WakeupEmbedThread();
 
-  // Wait for everything to be done.
-  uv_thread_join(&embed_thread_);
+    // Wait for everything to be done.
+    uv_thread_join(&embed_thread_);
+
+    uv_sem_destroy(&embed_sem_);
+  }
 
   // Clear uv.
-  uv_sem_destroy(&embed_sem_);
   dummy_uv_handle_.reset();
 
   // Clean up worker loop
@@ -537,9 +542,13 @@ void NodeBindings::PrepareMessageLoop() {
   // nothing to do.
   uv_async_init(uv_loop_, dummy_uv_handle_.get(), nullptr);
 
+  if (WatchBackendFd())
+    return;
+
   // Start worker that will interrupt main loop when having uv events.
   uv_sem_init(&embed_sem_, 0);
   uv_thread_create(&embed_thread_, EmbedThreadRunner, this);
+  embed_thread_started_ = true;
 }
 
 void NodeBindings::RunMessageLoop() {
@@ -585,11 +594,23 @@ void NodeBindings::UvRunOnce() {
 
   env->isolate()->SetMicrotasksPolicy(old_policy);
 
+  // The loop also runs the tasks V8 posts to Node's platform, which can
+  // queue microtasks without entering script.
+  if (browser_env_ == BrowserEnvironment::kBrowser)
+    MicrotasksRunner::ScheduleCheckpoint();
+
   if (r == 0)
     base::RunLoop().QuitWhenIdle();  // Quit from uv.
 
+  DidRunUvLoop();
+
   // Tell the worker thread to continue polling.
-  uv_sem_post(&embed_sem_);
+  if (embed_thread_started_)
+    uv_sem_post(&embed_sem_);
+}
+
+bool NodeBindings::WatchBackendFd() {
+  return false;
 }
 
 void NodeBindings::WakeupMainThread() {
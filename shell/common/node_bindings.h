@@ -116,6 +116,14 @@ class NodeBindings {
   // Called to poll events in new thread.
   virtual void PollEvents() = 0;
 
+  // Called to integrate uv's backend fd with the current thread's message
+  // loop directly, instead of polling it in a separate thread.  Returns false
+  // when the platform or process does not support it.
+  virtual bool WatchBackendFd();
+
+  // Called on the main thread after each run of the libuv loop.
+  virtual void DidRunUvLoop() {}
+
   // Run the libuv loop for once.
   void UvRunOnce();
 
@@ -141,6 +149,10 @@ class NodeBindings {
   // Whether the libuv loop has ended.
   bool embed_closed_ = false;
 
+  // Whether the embed thread polls uv events, false when the backend fd is
+  // watched by the message loop instead.
+  bool embed_thread_started_ = false;
+
   // Loop used when constructed in WORKER mode
   uv_loop_t worker_loop_;
 
@@ -6,6 +6,19 @@
 
 #include <sys/epoll.h>
 
+#include "base/bind.h"
+#include "base/feature_list.h"
+#include "base/task/current_thread.h"
+
+namespace features {
+
+// Runs libuv from the main thread's message loop whenever its backend fd is
+// readable, instead of waking the main thread from the embed thread.
+const base::Feature kElectronUvFdWatcher{"ElectronUvFdWatcher",
+                                         base::FEATURE_DISABLED_BY_DEFAULT};
+
+}  // namespace features
+
 namespace electron {
 
 NodeBindingsLinux::NodeBindingsLinux(BrowserEnvironment browser_env)
@@ -17,7 +30,10 @@ NodeBindingsLinux::NodeBindingsLinux(BrowserEnvironment browser_env)
   epoll_ctl(epoll_, EPOLL_CTL_ADD, backend_fd, &ev);
 }
 
-NodeBindingsLinux::~NodeBindingsLinux() = default;
+NodeBindingsLinux::~NodeBindingsLinux() {
+  backend_fd_controller_.StopWatchingFileDescriptor();
+  uv_timer_.Stop();
+}
 
 void NodeBindingsLinux::RunMessageLoop() {
   // Get notified when libuv's watcher queue changes.
@@ -31,11 +47,55 @@ void NodeBindingsLinux::RunMessageLoop() {
 void NodeBindingsLinux::OnWatcherQueueChanged(uv_loop_t* loop) {
   NodeBindingsLinux* self = static_cast<NodeBindingsLinux*>(loop->data);
 
+  // libuv only adds new watchers to its epoll set while the loop runs, so
+  // when the backend fd is watched directly the loop has to run again.
+  if (self->watching_backend_fd_) {
+    self->WakeupMainThread();
+    return;
+  }
+
   // We need to break the io polling in the epoll thread when loop's watcher
   // queue changes, otherwise new events cannot be notified.
   self->WakeupEmbedThread();
 }
 
+bool NodeBindingsLinux::WatchBackendFd() {
+  // Only the browser process runs libuv on a thread whose message pump can
+  // watch file descriptors.
+  if (browser_env_ != BrowserEnvironment::kBrowser ||
+      !base::FeatureList::IsEnabled(features::kElectronUvFdWatcher) ||
+      !base::CurrentUIThread::IsSet())
+    return false;
+
+  // Register with the pump directly so that libuv runs inline when the fd
+  // becomes readable. base::FileDescriptorWatcher would watch it on the IO
+  // thread and post a task back.
+  watching_backend_fd_ = base::CurrentUIThread::Get()->WatchFileDescriptor(
+      uv_backend_fd(uv_loop_), true /* persistent */,
+      base::MessagePumpForUI::WATCH_READ, &backend_fd_controller_, this);
+  return watching_backend_fd_;
+}
+
+void NodeBindingsLinux::OnFileCanReadWithoutBlocking(int fd) {
+  UvRunOnce();
+}
+
+void NodeBindingsLinux::OnFileCanWriteWithoutBlocking(int fd) {}
+
+void NodeBindingsLinux::DidRunUvLoop() {
+  if (!watching_backend_fd_)
+    return;
+
+  int timeout = uv_backend_timeout(uv_loop_);
+  if (timeout < 0) {
+    uv_timer_.Stop();
+    return;
+  }
+  uv_timer_.Start(FROM_HERE, base::TimeDelta::FromMilliseconds(timeout),
+                  base::BindOnce(&NodeBindingsLinux::UvRunOnce,
+                                 base::Unretained(this)));
+}
+
 void NodeBindingsLinux::PollEvents() {
   int timeout = uv_backend_timeout(uv_loop_);
 
@@ -6,11 +6,14 @@
 #define SHELL_COMMON_NODE_BINDINGS_LINUX_H_
 
 #include "base/compiler_specific.h"
+#include "base/message_loop/message_pump_for_ui.h"
+#include "base/timer/timer.h"
 #include "shell/common/node_bindings.h"
 
 namespace electron {
 
-class NodeBindingsLinux : public NodeBindings {
+class NodeBindingsLinux : public NodeBindings,
+                          public base::MessagePumpForUI::FdWatcher {
  public:
   explicit NodeBindingsLinux(BrowserEnvironment browser_env);
   ~NodeBindingsLinux() override;
@@ -22,10 +25,24 @@ class NodeBindingsLinux : public NodeBindings {
   static void OnWatcherQueueChanged(uv_loop_t* loop);
 
   void PollEvents() override;
+  bool WatchBackendFd() override;
+  void DidRunUvLoop() override;
+
+  // base::MessagePumpForUI::FdWatcher:
+  void OnFileCanReadWithoutBlocking(int fd) override;
+  void OnFileCanWriteWithoutBlocking(int fd) override;
 
   // Epoll to poll for uv's backend fd.
   int epoll_;
 
+  // Watches uv's backend fd from the main thread's message pump when the
+  // embed thread is not used.
+  base::MessagePumpForUI::FdWatchController backend_fd_controller_{FROM_HERE};
+  bool watching_backend_fd_ = false;
+
+  // Fires when the next libuv timer is due, the backend fd only reports I/O.
+  base::OneShotTimer uv_timer_;
+
   DISALLOW_COPY_AND_ASSIGN(NodeBindingsLinux);
 };
 
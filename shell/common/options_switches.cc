@@ -274,6 +274,12 @@ const char kGlobalCrashKeys[] = "global-crash-keys";
 
 const char kEnableWebSQL[] = "enable-websql";
 
+// How files are extracted from asar archives for native code.
+const char kAsarExtractMode[] = "asar-extract-mode";
+
+// Writes a prebuilt index next to every asar archive that is opened.
+const char kAsarWriteIndex[] = "asar-write-index";
+
 }  // namespace switches
 
 }  // namespace electron
@@ -134,6 +134,9 @@ extern const char kDisableNTLMv2[];
 extern const char kGlobalCrashKeys[];
 
 extern const char kEnableWebSQL[];
+
+extern const char kAsarExtractMode[];
+extern const char kAsarWriteIndex[];
 }  // namespace switches
 
 }  // namespace electron
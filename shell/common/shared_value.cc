@@ -0,0 +1,106 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/common/shared_value.h"
+
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "base/memory/ptr_util.h"
+#include "base/threading/platform_thread.h"
+
+namespace electron {
+
+namespace {
+
+// The region starts with this header, followed by the serialized value.
+// |sequence| is a seqlock: it is odd while the writer is updating the value,
+// and readers retry if it changed while they were copying.
+struct Header {
+  std::atomic<uint32_t> sequence;
+  std::atomic<uint32_t> replaced;
+  std::atomic<uint32_t> size;
+  uint32_t padding;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "shared value headers are accessed from several processes");
+
+// Readers only race with a writer that copies a small value, so a short spin
+// is enough to get a consistent snapshot.
+constexpr int kMaxReadAttempts = 100;
+
+}  // namespace
+
+SharedValueWriter::SharedValueWriter(base::MappedReadOnlyRegion region)
+    : region_(std::move(region)) {}
+
+SharedValueWriter::~SharedValueWriter() = default;
+
+// static
+std::unique_ptr<SharedValueWriter> SharedValueWriter::Create(size_t capacity) {
+  base::MappedReadOnlyRegion region =
+      base::ReadOnlySharedMemoryRegion::Create(sizeof(Header) + capacity);
+  if (!region.IsValid())
+    return nullptr;
+  new (region.mapping.memory()) Header{};
+  return base::WrapUnique(new SharedValueWriter(std::move(region)));
+}
+
+bool SharedValueWriter::Write(base::span<const uint8_t> data) {
+  if (data.size() > region_.mapping.size() - sizeof(Header) ||
+      data.size() > std::numeric_limits<uint32_t>::max())
+    return false;
+
+  auto* header = static_cast<Header*>(region_.mapping.memory());
+  const uint32_t sequence = header->sequence.load(std::memory_order_relaxed);
+  header->sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  header->size.store(data.size(), std::memory_order_relaxed);
+  memcpy(header + 1, data.data(), data.size());
+  header->sequence.store(sequence + 2, std::memory_order_release);
+  return true;
+}
+
+void SharedValueWriter::MarkReplaced() {
+  auto* header = static_cast<Header*>(region_.mapping.memory());
+  header->replaced.store(1, std::memory_order_release);
+}
+
+base::ReadOnlySharedMemoryRegion SharedValueWriter::DuplicateRegion() const {
+  return region_.region.Duplicate();
+}
+
+SharedValueReadResult ReadSharedValue(
+    const base::ReadOnlySharedMemoryMapping& mapping,
+    std::vector<uint8_t>* data) {
+  if (!mapping.IsValid() || mapping.size() < sizeof(Header))
+    return SharedValueReadResult::kFailed;
+
+  const auto* header = static_cast<const Header*>(mapping.memory());
+  for (int attempt = 0; attempt < kMaxReadAttempts; ++attempt) {
+    if (header->replaced.load(std::memory_order_acquire))
+      return SharedValueReadResult::kReplaced;
+
+    const uint32_t sequence = header->sequence.load(std::memory_order_acquire);
+    if (sequence % 2 == 0) {
+      const size_t size = header->size.load(std::memory_order_relaxed);
+      if (size > mapping.size() - sizeof(Header))
+        return SharedValueReadResult::kFailed;
+      const auto* begin = reinterpret_cast<const uint8_t*>(header + 1);
+      data->assign(begin, begin + size);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (header->sequence.load(std::memory_order_relaxed) == sequence)
+        return SharedValueReadResult::kSuccess;
+    }
+    base::PlatformThread::YieldCurrentThread();
+  }
+  return SharedValueReadResult::kFailed;
+}
+
+}  // namespace electron
@@ -0,0 +1,59 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_COMMON_SHARED_VALUE_H_
+#define SHELL_COMMON_SHARED_VALUE_H_
+
+#include <memory>
+#include <vector>
+
+#include "base/containers/span.h"
+#include "base/memory/read_only_shared_memory_region.h"
+
+namespace electron {
+
+// A serialized value that the browser process publishes in shared memory, so
+// renderers can read it without any IPC. The writer updates the value in
+// place as long as it fits, and readers see every update right away.
+class SharedValueWriter {
+ public:
+  SharedValueWriter(const SharedValueWriter&) = delete;
+  SharedValueWriter& operator=(const SharedValueWriter&) = delete;
+
+  ~SharedValueWriter();
+
+  // Returns null if the region could not be created.
+  static std::unique_ptr<SharedValueWriter> Create(size_t capacity);
+
+  // Returns false if |data| does not fit, leaving the value unchanged.
+  bool Write(base::span<const uint8_t> data);
+
+  // Tells readers to ask for the region again, because the value moved to a
+  // new region or was deleted.
+  void MarkReplaced();
+
+  base::ReadOnlySharedMemoryRegion DuplicateRegion() const;
+
+ private:
+  explicit SharedValueWriter(base::MappedReadOnlyRegion region);
+
+  base::MappedReadOnlyRegion region_;
+};
+
+enum class SharedValueReadResult {
+  kSuccess,
+  // The value moved to another region, which has to be requested again.
+  kReplaced,
+  // The region is malformed, or the writer kept changing the value.
+  kFailed,
+};
+
+// Copies a consistent snapshot of the value in |mapping| into |data|.
+SharedValueReadResult ReadSharedValue(
+    const base::ReadOnlySharedMemoryMapping& mapping,
+    std::vector<uint8_t>* data);
+
+}  // namespace electron
+
+#endif  // SHELL_COMMON_SHARED_VALUE_H_
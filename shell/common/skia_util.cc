@@ -2,6 +2,7 @@
 // Use of this source code is governed by the MIT license that can be
 // found in the LICENSE file.
 
+#include <memory>
 #include <string>
 
 #include "base/files/file_util.h"
@@ -9,6 +10,7 @@
 #include "base/strings/string_util.h"
 #include "base/threading/thread_restrictions.h"
 #include "net/base/data_url.h"
+#include "shell/common/asar/archive.h"
 #include "shell/common/asar/asar_util.h"
 #include "shell/common/node_includes.h"
 #include "shell/common/skia_util.h"
@@ -121,9 +123,17 @@ bool AddImageSkiaRepFromBuffer(gfx::ImageSkia* image,
 bool AddImageSkiaRepFromPath(gfx::ImageSkia* image,
                              const base::FilePath& path,
                              double scale_factor) {
+  // Decode packed asar files straight from the archive's mapping.
+  std::shared_ptr<asar::Archive> archive;
+  base::span<const uint8_t> mapped_contents;
   std::string file_contents;
   {
     base::ThreadRestrictions::ScopedAllowIO allow_io;
+    if (asar::GetPackedFileContents(path, &archive, &mapped_contents)) {
+      return AddImageSkiaRepFromBuffer(image, mapped_contents.data(),
+                                       mapped_contents.size(), 0, 0,
+                                       scale_factor);
+    }
     if (!asar::ReadFileToString(path, &file_contents))
       return false;
   }
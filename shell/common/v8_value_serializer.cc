@@ -4,18 +4,34 @@
 
 #include "shell/common/v8_value_serializer.h"
 
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "base/memory/read_only_shared_memory_region.h"
+#include "base/strings/strcat.h"
+#include "base/strings/string_number_conversions.h"
 #include "gin/converter.h"
+#include "mojo/public/cpp/base/big_buffer.h"
+#include "shell/common/api/api.mojom.h"
 #include "shell/common/gin_helper/microtasks_scope.h"
 #include "third_party/blink/public/common/messaging/cloneable_message.h"
+#include "third_party/blink/public/common/messaging/transferable_message.h"
 #include "v8/include/v8.h"
 
 namespace electron {
 
 namespace {
+
 const uint8_t kVersionTag = 0xFF;
+
+void DeleteTransferredBuffer(void* data, size_t length, void* deleter_data) {
+  delete static_cast<mojo_base::BigBuffer*>(deleter_data);
+}
+
 }  // namespace
 
 class V8Serializer : public v8::ValueSerializer::Delegate {
@@ -24,7 +40,9 @@ class V8Serializer : public v8::ValueSerializer::Delegate {
       : isolate_(isolate), serializer_(isolate, this) {}
   ~V8Serializer() override = default;
 
-  bool Serialize(v8::Local<v8::Value> value, blink::CloneableMessage* out) {
+  bool Serialize(v8::Local<v8::Value> value,
+                 blink::CloneableMessage* out,
+                 mojom::SharedMessagePayloadPtr* shared_out = nullptr) {
     gin_helper::MicrotasksScope microtasks_scope(
         isolate_, v8::MicrotasksScope::kDoNotRunMicrotasks);
     WriteBlinkEnvelope(19);
@@ -41,12 +59,64 @@ class V8Serializer : public v8::ValueSerializer::Delegate {
 
     std::pair<uint8_t*, size_t> buffer = serializer_.Release();
     DCHECK_EQ(buffer.first, data_.data());
+    // Large values are copied into a region of their exact size once they
+    // are complete, rather than grown in shared memory as they are written.
+    if (shared_out && buffer.second > kSharedPayloadThreshold) {
+      base::MappedReadOnlyRegion region =
+          base::ReadOnlySharedMemoryRegion::Create(buffer.second);
+      if (region.IsValid()) {
+        memcpy(region.mapping.memory(), buffer.first, buffer.second);
+        *shared_out = mojom::SharedMessagePayload::New(
+            std::move(region.region), buffer.second);
+        data_ = {};
+        return true;
+      }
+    }
+
     out->encoded_message = base::make_span(buffer.first, buffer.second);
     out->owned_encoded_message = std::move(data_);
 
     return true;
   }
 
+  bool Serialize(v8::Local<v8::Value> value,
+                 const std::vector<v8::Local<v8::ArrayBuffer>>& transfer_list,
+                 blink::TransferableMessage* out) {
+    for (size_t i = 0; i < transfer_list.size(); ++i) {
+      v8::Local<v8::ArrayBuffer> buffer = transfer_list[i];
+      if (std::find(transfer_list.begin(), transfer_list.begin() + i,
+                    buffer) != transfer_list.begin() + i) {
+        ThrowError(base::StrCat(
+            {"ArrayBuffer at index ", base::NumberToString(i),
+             " is a duplicate of an earlier ArrayBuffer."}));
+        return false;
+      }
+      if (!buffer->IsDetachable()) {
+        ThrowError(base::StrCat({"ArrayBuffer at index ",
+                                 base::NumberToString(i),
+                                 " could not be transferred."}));
+        return false;
+      }
+      serializer_.TransferArrayBuffer(i, buffer);
+    }
+
+    if (!Serialize(value, out))
+      return false;
+
+    // The buffers are only detached once the value was serialized, so a value
+    // that could not be cloned leaves them untouched. A BigBuffer cannot adopt
+    // V8's memory, so their contents are copied into the message once, either
+    // inline or into shared memory for large buffers.
+    for (v8::Local<v8::ArrayBuffer> buffer : transfer_list) {
+      std::shared_ptr<v8::BackingStore> contents = buffer->GetBackingStore();
+      out->array_buffer_contents_array.emplace_back(base::make_span(
+          static_cast<const uint8_t*>(contents->Data()),
+          contents->ByteLength()));
+      buffer->Detach();
+    }
+    return true;
+  }
+
   // v8::ValueSerializer::Delegate
   void* ReallocateBufferMemory(void* old_buffer,
                                size_t size,
@@ -67,6 +137,11 @@ class V8Serializer : public v8::ValueSerializer::Delegate {
   }
 
  private:
+  void ThrowError(const std::string& message) {
+    isolate_->ThrowException(
+        v8::Exception::Error(gin::StringToV8(isolate_, message)));
+  }
+
   void WriteTag(uint8_t tag) { serializer_.WriteRawBytes(&tag, 1); }
 
   void WriteBlinkEnvelope(uint32_t blink_version) {
@@ -88,6 +163,10 @@ class V8Deserializer : public v8::ValueDeserializer::Delegate {
         deserializer_(isolate, data.data(), data.size(), this) {}
   V8Deserializer(v8::Isolate* isolate, const blink::CloneableMessage& message)
       : V8Deserializer(isolate, message.encoded_message) {}
+  V8Deserializer(v8::Isolate* isolate, blink::TransferableMessage* message)
+      : V8Deserializer(isolate, message->encoded_message) {
+    transferred_buffers_ = &message->array_buffer_contents_array;
+  }
 
   v8::Local<v8::Value> Deserialize() {
     v8::EscapableHandleScope scope(isolate_);
@@ -101,6 +180,8 @@ class V8Deserializer : public v8::ValueDeserializer::Delegate {
     if (!deserializer_.ReadHeader(context).To(&read_header))
       return v8::Null(isolate_);
     DCHECK(read_header);
+    if (transferred_buffers_)
+      TransferArrayBuffers();
     v8::Local<v8::Value> value;
     if (!deserializer_.ReadValue(context).ToLocal(&value))
       return v8::Null(isolate_);
@@ -108,6 +189,34 @@ class V8Deserializer : public v8::ValueDeserializer::Delegate {
   }
 
  private:
+  void TransferArrayBuffers() {
+    for (size_t i = 0; i < transferred_buffers_->size(); ++i) {
+      auto contents = std::make_unique<mojo_base::BigBuffer>(
+          std::move((*transferred_buffers_)[i]));
+      std::unique_ptr<v8::BackingStore> backing_store;
+      if (contents->storage_type() !=
+          mojo_base::BigBuffer::StorageType::kBytes) {
+        // Large buffers arrive in shared memory the sender can still write
+        // to, so, like Blink, copy them into memory of our own.
+        backing_store =
+            v8::ArrayBuffer::NewBackingStore(isolate_, contents->size());
+        memcpy(backing_store->Data(), contents->data(), contents->size());
+      } else if (contents->size() == 0) {
+        backing_store = v8::ArrayBuffer::NewBackingStore(isolate_, 0);
+      } else {
+        // The ArrayBuffer adopts the received memory, which is freed along
+        // with its backing store.
+        void* data = contents->data();
+        size_t size = contents->size();
+        backing_store = v8::ArrayBuffer::NewBackingStore(
+            data, size, &DeleteTransferredBuffer, contents.release());
+      }
+      deserializer_.TransferArrayBuffer(
+          i, v8::ArrayBuffer::New(isolate_, std::move(backing_store)));
+    }
+    transferred_buffers_->clear();
+  }
+
   bool ReadTag(uint8_t* tag) {
     const void* tag_bytes = nullptr;
     if (!deserializer_.ReadRawBytes(1, &tag_bytes))
@@ -129,6 +238,7 @@ class V8Deserializer : public v8::ValueDeserializer::Delegate {
 
   v8::Isolate* isolate_;
   v8::ValueDeserializer deserializer_;
+  std::vector<mojo_base::BigBuffer>* transferred_buffers_ = nullptr;
 };
 
 bool SerializeV8Value(v8::Isolate* isolate,
@@ -137,14 +247,51 @@ bool SerializeV8Value(v8::Isolate* isolate,
   return V8Serializer(isolate).Serialize(value, out);
 }
 
+bool SerializeV8Value(v8::Isolate* isolate,
+                      v8::Local<v8::Value> value,
+                      blink::CloneableMessage* out,
+                      mojom::SharedMessagePayloadPtr* shared_out) {
+  return V8Serializer(isolate).Serialize(value, out, shared_out);
+}
+
+bool SerializeV8Value(
+    v8::Isolate* isolate,
+    v8::Local<v8::Value> value,
+    const std::vector<v8::Local<v8::ArrayBuffer>>& transfer_list,
+    blink::TransferableMessage* out) {
+  return V8Serializer(isolate).Serialize(value, transfer_list, out);
+}
+
 v8::Local<v8::Value> DeserializeV8Value(v8::Isolate* isolate,
                                         const blink::CloneableMessage& in) {
   return V8Deserializer(isolate, in).Deserialize();
 }
 
+v8::Local<v8::Value> DeserializeV8Value(v8::Isolate* isolate,
+                                        blink::TransferableMessage* in) {
+  return V8Deserializer(isolate, in).Deserialize();
+}
+
 v8::Local<v8::Value> DeserializeV8Value(v8::Isolate* isolate,
                                         base::span<const uint8_t> data) {
   return V8Deserializer(isolate, data).Deserialize();
 }
 
+v8::Local<v8::Value> DeserializeV8Value(
+    v8::Isolate* isolate,
+    const mojom::SharedMessagePayload& payload) {
+  base::ReadOnlySharedMemoryMapping mapping = payload.region.Map();
+  if (!mapping.IsValid() || payload.size > mapping.size())
+    return v8::Null(isolate);
+  // A compromised sender could keep the writable mapping it filled the region
+  // through, and keep writing to it while the deserializer reads lengths and
+  // then the bytes they describe. A copy-on-write mapping would not help, as
+  // pages are only copied when the receiver writes to them and otherwise
+  // still show the sender's writes, so deserialize a private copy instead.
+  base::span<const uint8_t> shared =
+      mapping.GetMemoryAsSpan<uint8_t>().first(payload.size);
+  std::vector<uint8_t> data(shared.begin(), shared.end());
+  return V8Deserializer(isolate, data).Deserialize();
+}
+
 }  // namespace electron
@@ -5,9 +5,13 @@
 #ifndef SHELL_COMMON_V8_VALUE_SERIALIZER_H_
 #define SHELL_COMMON_V8_VALUE_SERIALIZER_H_
 
+#include <vector>
+
 #include "base/containers/span.h"
+#include "shell/common/api/api.mojom-forward.h"
 
 namespace v8 {
+class ArrayBuffer;
 class Isolate;
 template <class T>
 class Local;
@@ -16,17 +20,44 @@ class Value;
 
 namespace blink {
 struct CloneableMessage;
-}
+struct TransferableMessage;
+}  // namespace blink
 
 namespace electron {
 
+// Serialized values above this size are sent in shared memory.
+constexpr size_t kSharedPayloadThreshold = 1024 * 1024;
+
 bool SerializeV8Value(v8::Isolate* isolate,
                       v8::Local<v8::Value> value,
                       blink::CloneableMessage* out);
+// Like above, but values whose serialized form is larger than
+// |kSharedPayloadThreshold| are copied into a shared memory region of their
+// size and returned in |shared_out|, leaving |out| empty.
+bool SerializeV8Value(v8::Isolate* isolate,
+                      v8::Local<v8::Value> value,
+                      blink::CloneableMessage* out,
+                      mojom::SharedMessagePayloadPtr* shared_out);
+// Like above, but moves the contents of the buffers in |transfer_list| into
+// |out| and detaches them, instead of cloning them.
+bool SerializeV8Value(
+    v8::Isolate* isolate,
+    v8::Local<v8::Value> value,
+    const std::vector<v8::Local<v8::ArrayBuffer>>& transfer_list,
+    blink::TransferableMessage* out);
 v8::Local<v8::Value> DeserializeV8Value(v8::Isolate* isolate,
                                         const blink::CloneableMessage& in);
+// Hands the buffers transferred in |in| to the deserialized ArrayBuffers,
+// which take ownership of them without copying.
+v8::Local<v8::Value> DeserializeV8Value(v8::Isolate* isolate,
+                                        blink::TransferableMessage* in);
 v8::Local<v8::Value> DeserializeV8Value(v8::Isolate* isolate,
                                         base::span<const uint8_t> data);
+// Copies the payload out of the shared memory once, then deserializes the
+// copy, as the sender may still be able to write to the region.
+v8::Local<v8::Value> DeserializeV8Value(
+    v8::Isolate* isolate,
+    const mojom::SharedMessagePayload& payload);
 
 }  // namespace electron
 
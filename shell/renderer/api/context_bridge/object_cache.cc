@@ -6,6 +6,7 @@
 
 #include <utility>
 
+#include "base/macros.h"
 #include "shell/common/api/object_life_monitor.h"
 
 namespace electron {
@@ -15,6 +16,8 @@ namespace api {
 namespace context_bridge {
 
 ObjectCache::ObjectCache() = default;
+ObjectCache::ObjectCache(v8::Local<v8::Map> shared_cache)
+    : shared_cache_(shared_cache) {}
 ObjectCache::~ObjectCache() = default;
 
 void ObjectCache::CacheProxiedObject(v8::Local<v8::Value> from,
@@ -23,7 +26,14 @@ void ObjectCache::CacheProxiedObject(v8::Local<v8::Value> from,
     auto obj = from.As<v8::Object>();
     int hash = obj->GetIdentityHash();
 
-    proxy_map_[hash].push_front(std::make_pair(from, proxy_value));
+    auto result = proxy_map_.emplace(hash, std::make_pair(from, proxy_value));
+    if (!result.second)
+      colliding_pairs_.emplace_back(from, proxy_value);
+
+    if (!shared_cache_.IsEmpty()) {
+      ignore_result(shared_cache_->Set(shared_cache_->CreationContext(), from,
+                                       proxy_value));
+    }
   }
 }
 
@@ -35,18 +45,23 @@ v8::MaybeLocal<v8::Value> ObjectCache::GetCachedProxiedObject(
   auto obj = from.As<v8::Object>();
   int hash = obj->GetIdentityHash();
   auto iter = proxy_map_.find(hash);
-  if (iter == proxy_map_.end())
-    return v8::MaybeLocal<v8::Value>();
+  if (iter != proxy_map_.end()) {
+    if (iter->second.first == from)
+      return iter->second.second;
 
-  auto& list = iter->second;
-  for (const auto& pair : list) {
-    auto from_cmp = pair.first;
-    if (from_cmp == from) {
-      if (pair.second.IsEmpty())
-        return v8::MaybeLocal<v8::Value>();
-      return pair.second;
+    for (const auto& pair : colliding_pairs_) {
+      if (pair.first == from)
+        return pair.second;
     }
   }
+
+  // Proxies are never undefined, so that means |from| is not in the map.
+  v8::Local<v8::Value> shared_value;
+  if (!shared_cache_.IsEmpty() &&
+      shared_cache_->Get(shared_cache_->CreationContext(), from)
+          .ToLocal(&shared_value) &&
+      !shared_value->IsUndefined())
+    return shared_value;
   return v8::MaybeLocal<v8::Value>();
 }
 
@@ -7,6 +7,7 @@
 
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "base/containers/linked_list.h"
 #include "content/public/renderer/render_frame.h"
@@ -25,8 +26,15 @@ using ObjectCachePair = std::pair<v8::Local<v8::Value>, v8::Local<v8::Value>>;
 class ObjectCache final {
  public:
   ObjectCache();
+  // Also records every proxied object in |shared_cache|, and looks up the
+  // objects it has not seen there, so that values passed by several
+  // ObjectCaches at different times keep being proxied by the same object.
+  explicit ObjectCache(v8::Local<v8::Map> shared_cache);
   ~ObjectCache();
 
+  ObjectCache(const ObjectCache&) = delete;
+  ObjectCache& operator=(const ObjectCache&) = delete;
+
   void CacheProxiedObject(v8::Local<v8::Value> from,
                           v8::Local<v8::Value> proxy_value);
   v8::MaybeLocal<v8::Value> GetCachedProxiedObject(
@@ -34,7 +42,12 @@ class ObjectCache final {
 
  private:
   // object_identity ==> [from_value, proxy_value]
-  std::unordered_map<int, std::forward_list<ObjectCachePair>> proxy_map_;
+  // Identity hashes rarely collide, so each hash maps to a single pair and the
+  // few objects whose hash is already taken go to |colliding_pairs_|.  This
+  // keeps a cache insertion down to one allocation.
+  std::unordered_map<int, ObjectCachePair> proxy_map_;
+  std::vector<ObjectCachePair> colliding_pairs_;
+  v8::Local<v8::Map> shared_cache_;
 };
 
 }  // namespace context_bridge
@@ -4,15 +4,17 @@
 
 #include "shell/renderer/api/electron_api_context_bridge.h"
 
+#include <cstring>
+#include <map>
 #include <memory>
-#include <set>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "base/feature_list.h"
-#include "base/no_destructor.h"
+#include "base/lazy_instance.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/threading/thread_local.h"
 #include "base/trace_event/trace_event.h"
 #include "content/public/renderer/render_frame.h"
 #include "content/public/renderer/render_frame_observer.h"
@@ -46,6 +48,10 @@ const char* const kSupportsDynamicPropertiesPrivateKey =
     "electron_contextBridge_supportsDynamicProperties";
 const char* const kOriginalFunctionPrivateKey =
     "electron_contextBridge_original_fn";
+const char* const kTransferPrivateKey = "electron_contextBridge_transfer";
+const char* const kLazyProxyPrivateKey = "electron_contextBridge_lazy_proxy";
+const char* const kLazyProxyCachePrivateKey =
+    "electron_contextBridge_lazy_proxy_cache";
 
 }  // namespace context_bridge
 
@@ -59,14 +65,14 @@ inline bool IsTrue(v8::Maybe<bool> maybe) {
 }
 
 // Sourced from "extensions/renderer/v8_schema_registry.cc"
-// Recursively freezes every v8 object on |object|.
+// Recursively freezes every v8 object on |object|, |frozen| tracks the objects
+// that have already been visited.
 bool DeepFreeze(const v8::Local<v8::Object>& object,
                 const v8::Local<v8::Context>& context,
-                std::set<int> frozen = std::set<int>()) {
-  int hash = object->GetIdentityHash();
-  if (frozen.find(hash) != frozen.end())
+                context_bridge::ObjectCache* frozen) {
+  if (!frozen->GetCachedProxiedObject(object).IsEmpty())
     return true;
-  frozen.insert(hash);
+  frozen->CacheProxiedObject(object, object);
 
   v8::Local<v8::Array> property_names =
       object->GetOwnPropertyNames(context).ToLocalChecked();
@@ -109,26 +115,130 @@ bool IsPlainArray(const v8::Local<v8::Value>& arr) {
   return !arr->IsTypedArray();
 }
 
+// Looking a private symbol up by name creates a string and searches the
+// isolate's symbol registry, which adds up when proxying thousands of
+// functions, so each key is only looked up once per isolate.
+struct PrivateKeys {
+  v8::Isolate* isolate = nullptr;
+  std::map<const char*, v8::Eternal<v8::Private>> keys;
+};
+
+// An isolate is only ever used on the thread that created it, and render and
+// worker threads each run a single isolate, so the keys are kept per thread
+// and freed along with worker threads. They are only handed out for the
+// isolate they were created in.
+base::LazyInstance<base::ThreadLocalOwnedPointer<PrivateKeys>>::Leaky
+    g_private_keys = LAZY_INSTANCE_INITIALIZER;
+
+v8::Local<v8::Private> GetPrivateKey(v8::Isolate* isolate, const char* key) {
+  PrivateKeys* private_keys = g_private_keys.Get().Get();
+  if (!private_keys || private_keys->isolate != isolate) {
+    auto new_keys = std::make_unique<PrivateKeys>();
+    new_keys->isolate = isolate;
+    private_keys = new_keys.get();
+    g_private_keys.Get().Set(std::move(new_keys));
+  }
+  v8::Eternal<v8::Private>& eternal = private_keys->keys[key];
+  if (eternal.IsEmpty()) {
+    eternal.Set(isolate,
+                v8::Private::ForApi(isolate, gin::StringToV8(isolate, key)));
+  }
+  return eternal.Get(isolate);
+}
+
 void SetPrivate(v8::Local<v8::Context> context,
                 v8::Local<v8::Object> target,
-                const std::string& key,
+                const char* key,
                 v8::Local<v8::Value> value) {
   target
-      ->SetPrivate(
-          context,
-          v8::Private::ForApi(context->GetIsolate(),
-                              gin::StringToV8(context->GetIsolate(), key)),
-          value)
+      ->SetPrivate(context, GetPrivateKey(context->GetIsolate(), key), value)
       .Check();
 }
 
 v8::MaybeLocal<v8::Value> GetPrivate(v8::Local<v8::Context> context,
                                      v8::Local<v8::Object> target,
-                                     const std::string& key) {
-  return target->GetPrivate(
-      context,
-      v8::Private::ForApi(context->GetIsolate(),
-                          gin::StringToV8(context->GetIsolate(), key)));
+                                     const char* key) {
+  return target->GetPrivate(context,
+                            GetPrivateKey(context->GetIsolate(), key));
+}
+
+// Creates the destination context's version of |buffer|.  The contents are
+// copied with a single memcpy, unless |buffer| was marked with
+// contextBridge.transfer(), in which case its backing store is handed over
+// without a copy and |buffer| is detached.
+v8::Local<v8::ArrayBuffer> PassArrayBufferToOtherContext(
+    v8::Local<v8::Context> source_context,
+    v8::Local<v8::Context> destination_context,
+    v8::Local<v8::ArrayBuffer> buffer,
+    context_bridge::ObjectCache* object_cache) {
+  auto cached_value = object_cache->GetCachedProxiedObject(buffer);
+  if (!cached_value.IsEmpty())
+    return cached_value.ToLocalChecked().As<v8::ArrayBuffer>();
+
+  v8::Isolate* isolate = destination_context->GetIsolate();
+  v8::Local<v8::Value> transfer;
+  bool should_transfer =
+      buffer->IsDetachable() &&
+      GetPrivate(source_context, buffer, context_bridge::kTransferPrivateKey)
+          .ToLocal(&transfer) &&
+      transfer->IsTrue();
+
+  v8::Context::Scope destination_context_scope(destination_context);
+  v8::Local<v8::ArrayBuffer> passed_buffer;
+  if (should_transfer) {
+    std::shared_ptr<v8::BackingStore> backing_store =
+        buffer->GetBackingStore();
+    buffer->Detach();
+    passed_buffer = v8::ArrayBuffer::New(isolate, std::move(backing_store));
+  } else {
+    size_t length = buffer->ByteLength();
+    passed_buffer = v8::ArrayBuffer::New(isolate, length);
+    if (length > 0) {
+      memcpy(passed_buffer->GetBackingStore()->Data(),
+             buffer->GetBackingStore()->Data(), length);
+    }
+  }
+  object_cache->CacheProxiedObject(buffer, passed_buffer);
+  return passed_buffer;
+}
+
+// Re-creates |view| in the destination context on top of the passed version
+// of its buffer, so views sharing a buffer keep sharing it.
+v8::MaybeLocal<v8::Value> PassArrayBufferViewToOtherContext(
+    v8::Local<v8::Context> source_context,
+    v8::Local<v8::Context> destination_context,
+    v8::Local<v8::ArrayBufferView> view,
+    context_bridge::ObjectCache* object_cache) {
+  v8::Local<v8::ArrayBuffer> buffer = PassArrayBufferToOtherContext(
+      source_context, destination_context, view->Buffer(), object_cache);
+  size_t offset = view->ByteOffset();
+
+  v8::Context::Scope destination_context_scope(destination_context);
+  v8::Local<v8::Value> passed_view;
+  if (view->IsDataView()) {
+    passed_view = v8::DataView::New(buffer, offset, view->ByteLength());
+  } else {
+    size_t length = view.As<v8::TypedArray>()->Length();
+#define PASS_TYPED_ARRAY(Type) \
+  if (view->Is##Type())        \
+    passed_view = v8::Type::New(buffer, offset, length);
+    PASS_TYPED_ARRAY(Uint8Array)
+    PASS_TYPED_ARRAY(Uint8ClampedArray)
+    PASS_TYPED_ARRAY(Int8Array)
+    PASS_TYPED_ARRAY(Uint16Array)
+    PASS_TYPED_ARRAY(Int16Array)
+    PASS_TYPED_ARRAY(Uint32Array)
+    PASS_TYPED_ARRAY(Int32Array)
+    PASS_TYPED_ARRAY(Float32Array)
+    PASS_TYPED_ARRAY(Float64Array)
+    PASS_TYPED_ARRAY(BigInt64Array)
+    PASS_TYPED_ARRAY(BigUint64Array)
+#undef PASS_TYPED_ARRAY
+  }
+  if (passed_view.IsEmpty())
+    return v8::MaybeLocal<v8::Value>();
+  object_cache->CacheProxiedObject(view, passed_view);
+  return v8::MaybeLocal<v8::Value>(passed_view);
 }
 
 }  // namespace
@@ -365,6 +475,21 @@ v8::MaybeLocal<v8::Value> PassValueToOtherContext(
     return v8::MaybeLocal<v8::Value>(passed_value.ToLocalChecked());
   }
 
+  // Binary data is re-wrapped in the destination context directly instead of
+  // going through the serializer, both worlds share the same isolate.
+  if (value->IsArrayBuffer()) {
+    return v8::MaybeLocal<v8::Value>(PassArrayBufferToOtherContext(
+        source_context, destination_context, value.As<v8::ArrayBuffer>(),
+        object_cache));
+  }
+  if (value->IsArrayBufferView()) {
+    auto passed_view = PassArrayBufferViewToOtherContext(
+        source_context, destination_context, value.As<v8::ArrayBufferView>(),
+        object_cache);
+    if (!passed_view.IsEmpty())
+      return passed_view;
+  }
+
   // Serializable objects
   blink::CloneableMessage ret;
   {
@@ -560,6 +685,126 @@ v8::MaybeLocal<v8::Object> CreateProxyForAPI(
   }
 }
 
+namespace {
+
+void LazyPropertyGetter(v8::Local<v8::Name> property,
+                        const v8::PropertyCallbackInfo<v8::Value>& info) {
+  TRACE_EVENT0("electron", "ContextBridge::LazyPropertyGetter");
+  CHECK(info.Data()->IsObject());
+  v8::Local<v8::Object> api_object = info.Data().As<v8::Object>();
+  v8::Local<v8::Context> source_context = api_object->CreationContext();
+  v8::Local<v8::Context> destination_context =
+      info.Holder()->CreationContext();
+
+  // Values are passed with the cache of the whole tree of lazy proxies, so
+  // that an object reachable from several properties is proxied only once.
+  v8::Local<v8::Value> tree_cache;
+  if (!GetPrivate(destination_context, info.Holder(),
+                  context_bridge::kLazyProxyCachePrivateKey)
+           .ToLocal(&tree_cache) ||
+      !tree_cache->IsMap())
+    return;
+
+  v8::Local<v8::Value> value;
+  {
+    v8::Context::Scope source_context_scope(source_context);
+    if (!api_object->Get(source_context, property).ToLocal(&value))
+      return;
+  }
+
+  bool freeze =
+      !base::FeatureList::IsEnabled(features::kContextBridgeMutability);
+  v8::Local<v8::Value> passed_value;
+  if (IsPlainObject(value)) {
+    v8::Local<v8::Object> proxy;
+    if (!CreateLazyProxyForAPI(value.As<v8::Object>(), source_context,
+                               destination_context, freeze,
+                               tree_cache.As<v8::Map>())
+             .ToLocal(&proxy))
+      return;
+    passed_value = proxy;
+  } else {
+    context_bridge::ObjectCache object_cache(tree_cache.As<v8::Map>());
+    if (!PassValueToOtherContext(source_context, destination_context, value,
+                                 &object_cache, false, 0)
+             .ToLocal(&passed_value))
+      return;
+    context_bridge::ObjectCache frozen;
+    if (freeze && passed_value->IsObject() && !passed_value->IsTypedArray() &&
+        !DeepFreeze(passed_value.As<v8::Object>(), destination_context,
+                    &frozen))
+      return;
+  }
+  // V8 replaces the lazy property with a plain data property holding this
+  // value, so the getter only runs on first access.
+  info.GetReturnValue().Set(passed_value);
+}
+
+}  // namespace
+
+v8::MaybeLocal<v8::Object> CreateLazyProxyForAPI(
+    const v8::Local<v8::Object>& api_object,
+    const v8::Local<v8::Context>& source_context,
+    const v8::Local<v8::Context>& destination_context,
+    bool freeze,
+    v8::Local<v8::Map> tree_cache) {
+  // Reuse the proxy if this object was already exposed, which also keeps
+  // recursive objects from creating a new proxy at every level.
+  v8::Local<v8::Value> cached_proxy;
+  if (GetPrivate(source_context, api_object,
+                 context_bridge::kLazyProxyPrivateKey)
+          .ToLocal(&cached_proxy) &&
+      cached_proxy->IsObject() &&
+      cached_proxy.As<v8::Object>()->CreationContext() == destination_context)
+    return cached_proxy.As<v8::Object>();
+
+  v8::Context::Scope destination_context_scope(destination_context);
+  v8::Local<v8::Object> proxy =
+      v8::Object::New(destination_context->GetIsolate());
+  SetPrivate(source_context, api_object, context_bridge::kLazyProxyPrivateKey,
+             proxy);
+  if (tree_cache.IsEmpty())
+    tree_cache = v8::Map::New(destination_context->GetIsolate());
+  SetPrivate(destination_context, proxy,
+             context_bridge::kLazyProxyCachePrivateKey, tree_cache);
+
+  v8::Local<v8::Array> keys;
+  if (!api_object
+           ->GetOwnPropertyNames(
+               source_context,
+               static_cast<v8::PropertyFilter>(v8::ONLY_ENUMERABLE))
+           .ToLocal(&keys))
+    return v8::MaybeLocal<v8::Object>();
+
+  auto attributes = freeze ? static_cast<v8::PropertyAttribute>(
+                                 v8::ReadOnly | v8::DontDelete)
+                           : v8::None;
+  uint32_t length = keys->Length();
+  for (uint32_t i = 0; i < length; i++) {
+    v8::Local<v8::Value> key;
+    if (!keys->Get(source_context, i).ToLocal(&key))
+      return v8::MaybeLocal<v8::Object>();
+    v8::Local<v8::Name> name;
+    if (key->IsName()) {
+      name = key.As<v8::Name>();
+    } else {
+      v8::Local<v8::String> key_string;
+      if (!key->ToString(source_context).ToLocal(&key_string))
+        return v8::MaybeLocal<v8::Object>();
+      name = key_string;
+    }
+    if (!IsTrue(proxy->SetLazyDataProperty(destination_context, name,
+                                           LazyPropertyGetter, api_object,
+                                           attributes)))
+      return v8::MaybeLocal<v8::Object>();
+  }
+
+  if (freeze && !IsTrue(proxy->SetIntegrityLevel(destination_context,
+                                                 v8::IntegrityLevel::kFrozen)))
+    return v8::MaybeLocal<v8::Object>();
+  return proxy;
+}
+
 void ExposeAPIInMainWorld(v8::Isolate* isolate,
                           const std::string& key,
                           v8::Local<v8::Value> api,
@@ -584,6 +829,27 @@ void ExposeAPIInMainWorld(v8::Isolate* isolate,
   v8::Local<v8::Context> isolated_context = frame->GetScriptContextFromWorldId(
       args->isolate(), WorldIDs::ISOLATED_WORLD_ID);
 
+  gin_helper::Dictionary options;
+  bool lazy = false;
+  if (args->GetNext(&options))
+    options.Get("lazy", &lazy);
+
+  if (lazy && IsPlainObject(api)) {
+    v8::Context::Scope main_context_scope(main_context);
+    bool freeze =
+        !base::FeatureList::IsEnabled(features::kContextBridgeMutability);
+    v8::Local<v8::Object> proxy;
+    if (!CreateLazyProxyForAPI(api.As<v8::Object>(), isolated_context,
+                               main_context, freeze)
+             .ToLocal(&proxy))
+      return;
+    if (freeze)
+      global.SetReadOnlyNonConfigurable(key, proxy);
+    else
+      global.Set(key, proxy);
+    return;
+  }
+
   {
     context_bridge::ObjectCache object_cache;
     v8::Context::Scope main_context_scope(main_context);
@@ -599,8 +865,9 @@ void ExposeAPIInMainWorld(v8::Isolate* isolate,
       return;
     }
 
+    context_bridge::ObjectCache frozen;
     if (proxy->IsObject() && !proxy->IsTypedArray() &&
-        !DeepFreeze(proxy.As<v8::Object>(), main_context))
+        !DeepFreeze(proxy.As<v8::Object>(), main_context, &frozen))
       return;
 
     global.SetReadOnlyNonConfigurable(key, proxy);
@@ -695,6 +962,38 @@ bool OverrideGlobalPropertyFromIsolatedWorld(
   }
 }
 
+v8::Local<v8::Value> MarkForTransfer(v8::Local<v8::Value> value,
+                                     gin_helper::Arguments* args) {
+  v8::Local<v8::ArrayBuffer> buffer;
+  if (value->IsArrayBuffer()) {
+    buffer = value.As<v8::ArrayBuffer>();
+  } else if (value->IsArrayBufferView()) {
+    auto view = value.As<v8::ArrayBufferView>();
+    buffer = view->Buffer();
+    // Transferring a view over part of a buffer, such as a pooled Node.js
+    // Buffer, would detach memory that other views still rely on.
+    if (view->ByteOffset() != 0 ||
+        view->ByteLength() != buffer->ByteLength()) {
+      args->ThrowError(
+          "Only an ArrayBufferView that spans its whole ArrayBuffer can be "
+          "transferred");
+      return v8::Local<v8::Value>();
+    }
+  } else {
+    args->ThrowError("Expected an ArrayBuffer or an ArrayBufferView");
+    return v8::Local<v8::Value>();
+  }
+
+  if (!buffer->IsDetachable()) {
+    args->ThrowError("The ArrayBuffer can not be transferred");
+    return v8::Local<v8::Value>();
+  }
+
+  SetPrivate(args->isolate()->GetCurrentContext(), buffer,
+             context_bridge::kTransferPrivateKey, v8::True(args->isolate()));
+  return value;
+}
+
 bool IsCalledFromMainWorld(v8::Isolate* isolate) {
   auto* render_frame = GetRenderFrame(isolate->GetCurrentContext()->Global());
   CHECK(render_frame);
@@ -717,6 +1016,7 @@ void Initialize(v8::Local<v8::Object> exports,
   v8::Isolate* isolate = context->GetIsolate();
   gin_helper::Dictionary dict(isolate, exports);
   dict.SetMethod("exposeAPIInMainWorld", &electron::api::ExposeAPIInMainWorld);
+  dict.SetMethod("markForTransfer", &electron::api::MarkForTransfer);
   dict.SetMethod("_overrideGlobalValueFromIsolatedWorld",
                  &electron::api::OverrideGlobalValueFromIsolatedWorld);
   dict.SetMethod("_overrideGlobalPropertyFromIsolatedWorld",
@@ -51,6 +51,17 @@ v8::MaybeLocal<v8::Object> CreateProxyForAPI(
     bool support_dynamic_properties,
     int recursion_depth);
 
+// Creates a proxy for |api_object| whose properties are only passed to
+// |destination_context| when they are first read.  Nested plain objects get
+// lazy proxies of their own, which share |tree_cache| of the values passed so
+// far with the root proxy.  A new cache is created when it is empty.
+v8::MaybeLocal<v8::Object> CreateLazyProxyForAPI(
+    const v8::Local<v8::Object>& api_object,
+    const v8::Local<v8::Context>& source_context,
+    const v8::Local<v8::Context>& destination_context,
+    bool freeze,
+    v8::Local<v8::Map> tree_cache = v8::Local<v8::Map>());
+
 }  // namespace api
 
 }  // namespace electron
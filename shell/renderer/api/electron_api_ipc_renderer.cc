@@ -2,12 +2,16 @@
 // Use of this source code is governed by the MIT license that can be
 // found in the LICENSE file.
 
+#include <map>
 #include <string>
+#include <vector>
 
+#include "base/no_destructor.h"
 #include "base/task/post_task.h"
 #include "base/values.h"
 #include "content/public/renderer/render_frame.h"
 #include "content/public/renderer/render_frame_observer.h"
+#include "content/public/renderer/render_thread.h"
 #include "gin/dictionary.h"
 #include "gin/handle.h"
 #include "gin/object_template_builder.h"
@@ -21,6 +25,7 @@
 #include "shell/common/gin_helper/promise.h"
 #include "shell/common/node_bindings.h"
 #include "shell/common/node_includes.h"
+#include "shell/common/shared_value.h"
 #include "shell/common/v8_value_serializer.h"
 #include "third_party/blink/public/common/browser_interface_broker_proxy.h"
 #include "third_party/blink/public/web/web_local_frame.h"
@@ -42,6 +47,60 @@ RenderFrame* GetCurrentRenderFrame() {
   return RenderFrame::FromWebFrame(frame);
 }
 
+// Reads the values published with ipcMain.setSharedValue() for all frames of
+// the process. The region of each value is requested once, and read directly
+// from then on until the browser process replaces it.
+class SharedValueReader {
+ public:
+  static SharedValueReader* GetInstance() {
+    static base::NoDestructor<SharedValueReader> instance;
+    return instance.get();
+  }
+
+  SharedValueReader() = default;
+
+  SharedValueReader(const SharedValueReader&) = delete;
+  SharedValueReader& operator=(const SharedValueReader&) = delete;
+
+  // Returns false if there is no value for |key|.
+  bool Read(const std::string& key, std::vector<uint8_t>* data) {
+    // The value can move to a new region while it is being requested, so
+    // allow for one more request than strictly needed.
+    for (int attempt = 0; attempt < 3; ++attempt) {
+      auto it = mappings_.find(key);
+      if (it == mappings_.end()) {
+        base::ReadOnlySharedMemoryRegion region;
+        GetHost()->GetSharedValueRegion(key, &region);
+        if (!region.IsValid())
+          return false;
+        it = mappings_.emplace(key, region.Map()).first;
+      }
+      switch (electron::ReadSharedValue(it->second, data)) {
+        case electron::SharedValueReadResult::kSuccess:
+          return true;
+        case electron::SharedValueReadResult::kReplaced:
+          mappings_.erase(it);
+          break;
+        case electron::SharedValueReadResult::kFailed:
+          return false;
+      }
+    }
+    return false;
+  }
+
+ private:
+  const mojo::Remote<electron::mojom::ElectronSharedValueHost>& GetHost() {
+    if (!host_) {
+      content::RenderThread::Get()->BindHostReceiver(
+          host_.BindNewPipeAndPassReceiver());
+    }
+    return host_;
+  }
+
+  mojo::Remote<electron::mojom::ElectronSharedValueHost> host_;
+  std::map<std::string, base::ReadOnlySharedMemoryMapping> mappings_;
+};
+
 class IPCRenderer : public gin::Wrappable<IPCRenderer>,
                     public content::RenderFrameObserver {
  public:
@@ -81,7 +140,8 @@ class IPCRenderer : public gin::Wrappable<IPCRenderer>,
         .SetMethod("sendTo", &IPCRenderer::SendTo)
         .SetMethod("sendToHost", &IPCRenderer::SendToHost)
         .SetMethod("invoke", &IPCRenderer::Invoke)
-        .SetMethod("postMessage", &IPCRenderer::PostMessage);
+        .SetMethod("postMessage", &IPCRenderer::PostMessage)
+        .SetMethod("getSharedValue", &IPCRenderer::GetSharedValue);
   }
 
   const char* GetTypeName() override { return "IPCRenderer"; }
@@ -97,10 +157,13 @@ class IPCRenderer : public gin::Wrappable<IPCRenderer>,
       return;
     }
     blink::CloneableMessage message;
-    if (!electron::SerializeV8Value(isolate, arguments, &message)) {
+    electron::mojom::SharedMessagePayloadPtr shared_message;
+    if (!electron::SerializeV8Value(isolate, arguments, &message,
+                                    &shared_message)) {
       return;
     }
-    electron_browser_remote_->Message(internal, channel, std::move(message));
+    electron_browser_remote_->Message(internal, channel, std::move(message),
+                                      std::move(shared_message));
   }
 
   v8::Local<v8::Promise> Invoke(v8::Isolate* isolate,
@@ -113,14 +176,16 @@ class IPCRenderer : public gin::Wrappable<IPCRenderer>,
       return v8::Local<v8::Promise>();
     }
     blink::CloneableMessage message;
-    if (!electron::SerializeV8Value(isolate, arguments, &message)) {
+    electron::mojom::SharedMessagePayloadPtr shared_message;
+    if (!electron::SerializeV8Value(isolate, arguments, &message,
+                                    &shared_message)) {
       return v8::Local<v8::Promise>();
     }
     gin_helper::Promise<blink::CloneableMessage> p(isolate);
     auto handle = p.GetHandle();
 
     electron_browser_remote_->Invoke(
-        internal, channel, std::move(message),
+        internal, channel, std::move(message), std::move(shared_message),
         base::BindOnce(
             [](gin_helper::Promise<blink::CloneableMessage> p,
                blink::CloneableMessage result) { p.Resolve(result); },
@@ -138,14 +203,7 @@ class IPCRenderer : public gin::Wrappable<IPCRenderer>,
       thrower.ThrowError(kIPCMethodCalledAfterContextReleasedError);
       return;
     }
-    blink::TransferableMessage transferable_message;
-    if (!electron::SerializeV8Value(isolate, message_value,
-                                    &transferable_message)) {
-      // SerializeV8Value sets an exception.
-      return;
-    }
-
-    std::vector<v8::Local<v8::Object>> transferables;
+    std::vector<v8::Local<v8::Value>> transferables;
     if (transfer) {
       if (!gin::ConvertFromV8(isolate, *transfer, &transferables)) {
         thrower.ThrowTypeError("Invalid value for transfer");
@@ -153,8 +211,28 @@ class IPCRenderer : public gin::Wrappable<IPCRenderer>,
       }
     }
 
-    std::vector<blink::MessagePortChannel> ports;
+    std::vector<v8::Local<v8::ArrayBuffer>> array_buffers;
+    std::vector<v8::Local<v8::Object>> message_ports;
     for (auto& transferable : transferables) {
+      if (transferable->IsArrayBuffer()) {
+        array_buffers.push_back(transferable.As<v8::ArrayBuffer>());
+      } else if (transferable->IsObject()) {
+        message_ports.push_back(transferable.As<v8::Object>());
+      } else {
+        thrower.ThrowTypeError("Invalid value for transfer");
+        return;
+      }
+    }
+
+    blink::TransferableMessage transferable_message;
+    if (!electron::SerializeV8Value(isolate, message_value, array_buffers,
+                                    &transferable_message)) {
+      // SerializeV8Value sets an exception.
+      return;
+    }
+
+    std::vector<blink::MessagePortChannel> ports;
+    for (auto& transferable : message_ports) {
       absl::optional<blink::MessagePortChannel> port =
           blink::WebMessagePortConverter::
               DisentangleAndExtractMessagePortChannel(isolate, transferable);
@@ -223,6 +301,14 @@ class IPCRenderer : public gin::Wrappable<IPCRenderer>,
     return electron::DeserializeV8Value(isolate, result);
   }
 
+  v8::Local<v8::Value> GetSharedValue(v8::Isolate* isolate,
+                                      const std::string& key) {
+    std::vector<uint8_t> data;
+    if (!SharedValueReader::GetInstance()->Read(key, &data))
+      return v8::Undefined(isolate);
+    return electron::DeserializeV8Value(isolate, data);
+  }
+
   v8::Global<v8::Context> weak_context_;
   mojo::Remote<electron::mojom::ElectronBrowser> electron_browser_remote_;
 };
@@ -174,6 +174,7 @@ void ElectronApiServiceImpl::Message(bool internal,
 }
 
 void ElectronApiServiceImpl::ReceivePostMessage(
+    bool internal,
     const std::string& channel,
     blink::TransferableMessage message) {
   blink::WebLocalFrame* frame = render_frame()->GetWebFrame();
@@ -186,7 +187,7 @@ void ElectronApiServiceImpl::ReceivePostMessage(
   v8::Local<v8::Context> context = renderer_client_->GetContext(frame, isolate);
   v8::Context::Scope context_scope(context);
 
-  v8::Local<v8::Value> message_value = DeserializeV8Value(isolate, message);
+  v8::Local<v8::Value> message_value = DeserializeV8Value(isolate, &message);
 
   std::vector<v8::Local<v8::Value>> ports;
   for (auto& port : message.ports) {
@@ -197,8 +198,8 @@ void ElectronApiServiceImpl::ReceivePostMessage(
 
   std::vector<v8::Local<v8::Value>> args = {message_value};
 
-  EmitIPCEvent(context, false, channel, ports, gin::ConvertToV8(isolate, args),
-               0);
+  EmitIPCEvent(context, internal, channel, ports,
+               gin::ConvertToV8(isolate, args), 0);
 }
 
 void ElectronApiServiceImpl::TakeHeapSnapshot(
@@ -12,6 +12,7 @@
 #include "base/command_line.h"
 #include "base/strings/string_split.h"
 #include "base/strings/stringprintf.h"
+#include "base/task/thread_pool.h"
 #include "components/network_hints/renderer/web_prescient_networking_impl.h"
 #include "content/common/buildflags.h"
 #include "content/public/common/content_constants.h"
@@ -21,9 +22,12 @@
 #include "content/public/renderer/render_view.h"
 #include "electron/buildflags/buildflags.h"
 #include "media/blink/multibuffer_data_source.h"
+#include "mojo/public/cpp/bindings/shared_remote.h"
 #include "printing/buildflags/buildflags.h"
 #include "shell/browser/api/electron_api_protocol.h"
+#include "shell/common/api/api.mojom.h"
 #include "shell/common/api/electron_api_native_image.h"
+#include "shell/common/asar/asar_util.h"
 #include "shell/common/color_util.h"
 #include "shell/common/gin_helper/dictionary.h"
 #include "shell/common/node_includes.h"
@@ -105,6 +109,14 @@ std::vector<std::string> ParseSchemesCLISwitch(base::CommandLine* command_line,
                            base::SPLIT_WANT_NONEMPTY);
 }
 
+base::ReadOnlySharedMemoryRegion GetArchiveIndexFromBrowser(
+    const mojo::SharedRemote<mojom::ElectronAsarHost>& asar_host,
+    const base::FilePath& path) {
+  base::ReadOnlySharedMemoryRegion index;
+  asar_host->GetArchiveIndex(path, &index);
+  return index;
+}
+
 // static
 RendererClientBase* g_renderer_client_base = nullptr;
 
@@ -235,6 +247,18 @@ void RendererClientBase::RenderThreadStarted() {
   blink::WebSecurityPolicy::RegisterURLSchemeAsAllowingServiceWorkers("file");
   blink::SchemeRegistry::RegisterURLSchemeAsSupportingFetchAPI("file");
 
+  // Reuse the asar indexes built by the browser process instead of parsing the
+  // same headers again in every renderer. The remote is bound on its own
+  // sequence so that worker threads can make the sync call too.
+  mojo::PendingRemote<mojom::ElectronAsarHost> asar_host;
+  content::RenderThread::Get()->BindHostReceiver(
+      asar_host.InitWithNewPipeAndPassReceiver());
+  asar::SetArchiveIndexProvider(base::BindRepeating(
+      &GetArchiveIndexFromBrowser,
+      mojo::SharedRemote<mojom::ElectronAsarHost>(
+          std::move(asar_host), base::ThreadPool::CreateSequencedTaskRunner(
+                                    {base::TaskPriority::USER_BLOCKING}))));
+
 #if defined(OS_WIN)
   // Set ApplicationUserModelID in renderer process.
   std::wstring app_id =
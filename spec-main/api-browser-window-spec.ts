@@ -3237,6 +3237,65 @@ describe('BrowserWindow module', () => {
         // upstream native_mate's implementation to gin.
       }).to.throw('Error processing argument at index 1, conversion failure from ');
     });
+
+    it('delivers i420 frames at the requested size', (done) => {
+      const w = new BrowserWindow({ show: false });
+      let called = false;
+      w.loadFile(path.join(fixtures, 'api', 'frame-subscriber.html'));
+      w.webContents.on('dom-ready', () => {
+        const size = { width: 64, height: 48 };
+        w.webContents.on('captured-video-frame', (event, frame) => {
+          if (called) return;
+          called = true;
+
+          try {
+            expect(frame.format).to.equal('i420');
+            expect(frame.width).to.equal(size.width);
+            expect(frame.height).to.equal(size.height);
+            const chromaSize = (size.width / 2) * (size.height / 2);
+            expect(frame.data).to.be.an.instanceOf(Buffer).with.lengthOf(size.width * size.height + chromaSize * 2);
+            done();
+          } catch (e) {
+            done(e);
+          } finally {
+            w.webContents.endFrameSubscription();
+          }
+        });
+        w.webContents.beginFrameSubscription({ pixelFormat: 'i420', size });
+      });
+    });
+
+    it('delivers an encoded key frame when a codec is set', async function () {
+      const w = new BrowserWindow({ show: false });
+      await w.loadFile(path.join(fixtures, 'api', 'frame-subscriber.html'));
+      const packetPromise = emittedOnce(w.webContents, 'encoded-video-packet');
+      try {
+        w.webContents.beginFrameSubscription({ codec: 'vp8' });
+      } catch (e) {
+        if (/not supported in this build/.test(e.message)) return this.skip();
+        throw e;
+      }
+      try {
+        const [, packet] = await packetPromise;
+        expect(packet.keyFrame).to.be.true('first packet is not a key frame');
+        expect(packet.data).to.be.an.instanceOf(Buffer);
+        expect(packet.data.length).to.be.greaterThan(0);
+        expect(packet.codec).to.equal('vp8');
+        expect(packet.timestamp).to.be.a('number');
+      } finally {
+        w.webContents.endFrameSubscription();
+      }
+    });
+
+    it('throws when the options are invalid', () => {
+      const w = new BrowserWindow({ show: false });
+      expect(() => {
+        w.webContents.beginFrameSubscription({ frameRate: 0 }, () => {});
+      }).to.throw('frameRate must be between 1 and 240');
+      expect(() => {
+        w.webContents.beginFrameSubscription({ pixelFormat: 'rgb565' }, () => {});
+      }).to.throw("pixelFormat must be 'argb' or 'i420'");
+    });
   });
 
   describe('savePage method', () => {
@@ -4535,6 +4594,55 @@ describe('BrowserWindow module', () => {
       });
     });
 
+    describe('window.webContents.setFrameRingSize()', () => {
+      it('delivers frames through paint-frame', async () => {
+        w.webContents.setFrameRingSize(2);
+        const paintFrame = emittedOnce(w.webContents, 'paint-frame');
+        w.loadFile(path.join(fixtures, 'api', 'offscreen-rendering.html'));
+        const [, frame] = await paintFrame;
+        expect(frame.data).to.be.an.instanceOf(ArrayBuffer);
+        expect(frame.data.byteLength).to.equal(frame.size.width * frame.size.height * 4);
+        const { scaleFactor } = screen.getPrimaryDisplay();
+        expect(frame.size.width).to.be.closeTo(100 * scaleFactor, 2);
+        expect(frame.sequence).to.be.a('number');
+        expect(frame.dirtyRect).to.have.property('width');
+        frame.release();
+        expect(frame.data.byteLength).to.equal(0);
+      });
+
+      it('repaints frames dropped while every buffer was in use once one is released', async () => {
+        w.webContents.setFrameRingSize(1);
+        w.loadFile(path.join(fixtures, 'api', 'offscreen-rendering.html'));
+        const [, first] = await emittedOnce(w.webContents, 'paint-frame');
+        const frames: any[] = [];
+        const onFrame = (event: any, frame: any) => frames.push(frame);
+        w.webContents.on('paint-frame', onFrame);
+        defer(() => w.webContents.removeListener('paint-frame', onFrame));
+
+        // The only buffer is held, so this repaint is dropped.
+        w.webContents.invalidate();
+        await delay(500);
+        expect(frames).to.be.empty();
+
+        const secondFrame = emittedOnce(w.webContents, 'paint-frame');
+        first.release();
+        const [, second] = await secondFrame;
+        expect(second.sequence).to.equal(first.sequence + 1);
+        expect(second.size).to.deep.equal(first.size);
+        expect(second.dirtyRect).to.deep.equal({ x: 0, y: 0, ...first.size });
+        second.release();
+      });
+
+      it('goes back to paint events when disabled', async () => {
+        w.webContents.setFrameRingSize(2);
+        w.webContents.setFrameRingSize(0);
+        const paint = emittedOnce(w.webContents, 'paint');
+        w.loadFile(path.join(fixtures, 'api', 'offscreen-rendering.html'));
+        const [,, image] = await paint;
+        expect(image.isEmpty()).to.be.false('image is empty');
+      });
+    });
+
     describe('frameRate APIs', () => {
       it('has default frame rate (function)', async () => {
         w.loadFile(path.join(fixtures, 'api', 'offscreen-rendering.html'));
@@ -4570,5 +4678,60 @@ describe('BrowserWindow module', () => {
         expect(w.webContents.frameRate).to.equal(30);
       });
     });
+
+    describe('popups', () => {
+      // Returns the pixel at |point|, given in DIPs, of a frame of |w|.
+      const getPixel = (image: Electron.NativeImage, point: Electron.Point) => {
+        const scale = image.getSize().width / w.getContentSize()[0];
+        const x = Math.floor(point.x * scale);
+        const y = Math.floor(point.y * scale);
+        const bitmap = image.crop({ x, y, width: 1, height: 1 }).toBitmap();
+        return { x, y, pixel: bitmap };
+      };
+
+      // Green is the second channel of both RGBA and BGRA bitmaps.
+      const isGreen = (pixel: Buffer) => pixel[1] > 200 && pixel[0] < 50 && pixel[2] < 50;
+
+      it('composites an open <select> popup into the frame', async () => {
+        // Below the select, covered by the popup once it opens.
+        const insidePopup = { x: 30, y: 50 };
+        // Never covered by the popup.
+        const outsidePopup = { x: 190, y: 190 };
+
+        w.setContentSize(200, 200);
+        await w.loadFile(path.join(fixtures, 'api', 'offscreen-select.html'));
+
+        const [, , closed] = await emittedOnce(w.webContents, 'paint');
+        expect(isGreen(getPixel(closed, insidePopup).pixel)).to.be.false('popup drawn before it was opened');
+
+        w.webContents.sendInputEvent({ type: 'mouseDown', x: 20, y: 20, button: 'left', clickCount: 1 });
+        w.webContents.sendInputEvent({ type: 'mouseUp', x: 20, y: 20, button: 'left', clickCount: 1 });
+
+        const [dirtyRect, image] = await new Promise<[Electron.Rectangle, Electron.NativeImage]>((resolve) => {
+          const onPaint = (event: Electron.Event, dirty: Electron.Rectangle, frame: Electron.NativeImage) => {
+            if (!isGreen(getPixel(frame, insidePopup).pixel)) return;
+            w.webContents.removeListener('paint', onPaint);
+            resolve([dirty, frame]);
+          };
+          w.webContents.on('paint', onPaint);
+        });
+
+        // The popup is inside the reported damage, which stays inside the
+        // frame.
+        const { width, height } = image.getSize();
+        const { x, y } = getPixel(image, insidePopup);
+        expect(dirtyRect.x).to.be.at.least(0);
+        expect(dirtyRect.y).to.be.at.least(0);
+        expect(dirtyRect.x + dirtyRect.width).to.be.at.most(width);
+        expect(dirtyRect.y + dirtyRect.height).to.be.at.most(height);
+        expect(x).to.be.within(dirtyRect.x, dirtyRect.x + dirtyRect.width - 1);
+        expect(y).to.be.within(dirtyRect.y, dirtyRect.y + dirtyRect.height - 1);
+
+        // The page around the popup is still there.
+        const { pixel } = getPixel(image, outsidePopup);
+        expect(pixel[1]).to.be.below(50);
+        expect(Math.max(pixel[0], pixel[2])).to.be.above(200);
+      });
+    });
   });
 });
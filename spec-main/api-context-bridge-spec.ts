@@ -150,6 +150,115 @@ describe('contextBridge', () => {
         expect(result).to.equal(123);
       });
 
+      it('should freeze every object in a large API', async () => {
+        await makeBindingWindow(() => {
+          const api: Record<string, any> = {};
+          for (let i = 0; i < 3000; i++) {
+            api[`group${i}`] = { fn: () => i, data: { value: i } };
+          }
+          contextBridge.exposeInMainWorld('example', api);
+        });
+        const result = await callWithBindings((root: any) => {
+          const groups = Object.values(root.example) as any[];
+          return [
+            groups.length,
+            groups.every(group => Object.isFrozen(group) && Object.isFrozen(group.data)),
+            root.example.group2999.fn()
+          ];
+        });
+        expect(result).to.deep.equal([3000, true, 2999]);
+      });
+
+      describe('with lazy: true', () => {
+        it('should proxy nested values', async () => {
+          await makeBindingWindow(() => {
+            contextBridge.exposeInMainWorld('example', {
+              num: 1,
+              nested: { fn: () => 123, data: [1, 2] }
+            }, { lazy: true });
+          });
+          const result = await callWithBindings((root: any) => {
+            return [
+              root.example.num,
+              root.example.nested.fn(),
+              root.example.nested.data,
+              Object.keys(root.example.nested)
+            ];
+          });
+          expect(result).to.deep.equal([1, 123, [1, 2], ['fn', 'data']]);
+        });
+
+        it('should freeze the proxies', async () => {
+          await makeBindingWindow(() => {
+            contextBridge.exposeInMainWorld('example', {
+              num: 1,
+              nested: { data: [1, 2] }
+            }, { lazy: true });
+          });
+          const result = await callWithBindings((root: any) => {
+            root.example.num = 2;
+            root.example.nested.data[0] = 5;
+            return [
+              root.example.num,
+              root.example.nested.data,
+              Object.isFrozen(root.example),
+              Object.isFrozen(root.example.nested)
+            ];
+          });
+          expect(result).to.deep.equal([1, [1, 2], true, true]);
+        });
+
+        it('should read properties on first access', async () => {
+          await makeBindingWindow(() => {
+            const nested = { value: 1 };
+            contextBridge.exposeInMainWorld('example', {
+              nested,
+              setValue: (value: number) => { nested.value = value; }
+            }, { lazy: true });
+          });
+          const result = await callWithBindings((root: any) => {
+            root.example.setValue(2);
+            const first = root.example.nested.value;
+            root.example.setValue(3);
+            return [first, root.example.nested.value];
+          });
+          expect(result).to.deep.equal([2, 2]);
+        });
+
+        it('should keep values shared by several properties identical', async () => {
+          await makeBindingWindow(() => {
+            const fn = () => 123;
+            const data = [1, 2];
+            contextBridge.exposeInMainWorld('example', {
+              fn,
+              alsoFn: fn,
+              nested: { fn, data },
+              data
+            }, { lazy: true });
+          });
+          const result = await callWithBindings((root: any) => {
+            return [
+              root.example.fn === root.example.alsoFn,
+              root.example.fn === root.example.nested.fn,
+              root.example.data === root.example.nested.data
+            ];
+          });
+          expect(result).to.deep.equal([true, true, true]);
+        });
+
+        it('should handle recursive objects', async () => {
+          await makeBindingWindow(() => {
+            const o: any = { value: 135 };
+            o.o = o;
+            contextBridge.exposeInMainWorld('example', { o }, { lazy: true });
+          });
+          const result = await callWithBindings((root: any) => {
+            return [root.example.o.o.o.value, root.example.o.o === root.example.o];
+          });
+          expect(result).to.deep.equal([135, true]);
+        });
+      });
+
       it('should proxy strings', async () => {
         await makeBindingWindow(() => {
           contextBridge.exposeInMainWorld('example', 'my-words');
@@ -543,6 +652,65 @@ describe('contextBridge', () => {
         expect(result).to.deep.equal([true, true]);
       });
 
+      it('should copy ArrayBuffers without sharing memory', async () => {
+        await makeBindingWindow(() => {
+          const buffer = new Uint8Array([1, 2, 3]);
+          contextBridge.exposeInMainWorld('example', {
+            getBuffer: () => buffer,
+            readBuffer: () => Array.from(buffer)
+          });
+        });
+        const result = await callWithBindings((root: any) => {
+          const buffer = root.example.getBuffer();
+          buffer[0] = 42;
+          return [Object.getPrototypeOf(buffer) === Uint8Array.prototype, Array.from(buffer), root.example.readBuffer()];
+        });
+        expect(result).to.deep.equal([true, [42, 2, 3], [1, 2, 3]]);
+      });
+
+      it('should keep views over the same ArrayBuffer sharing it', async () => {
+        await makeBindingWindow(() => {
+          const buffer = new ArrayBuffer(8);
+          contextBridge.exposeInMainWorld('example', {
+            getViews: () => ({ head: new Uint8Array(buffer, 0, 4), tail: new DataView(buffer, 4) })
+          });
+        });
+        const result = await callWithBindings((root: any) => {
+          const { head, tail } = root.example.getViews();
+          return [head.buffer === tail.buffer, head.byteOffset, head.length, tail.byteOffset, tail.byteLength];
+        });
+        expect(result).to.deep.equal([true, 0, 4, 4, 4]);
+      });
+
+      it('should transfer ArrayBuffers marked with contextBridge.transfer', async () => {
+        await makeBindingWindow(() => {
+          const buffer = new Float32Array([1, 2, 3]);
+          contextBridge.exposeInMainWorld('example', {
+            getBuffer: () => contextBridge.transfer(buffer),
+            getByteLength: () => buffer.byteLength
+          });
+        });
+        const result = await callWithBindings((root: any) => {
+          const buffer = root.example.getBuffer();
+          return [Object.getPrototypeOf(buffer) === Float32Array.prototype, Array.from(buffer), root.example.getByteLength()];
+        });
+        expect(result).to.deep.equal([true, [1, 2, 3], 0]);
+      });
+
+      it('should refuse to transfer a view over part of an ArrayBuffer', async () => {
+        await makeBindingWindow(() => {
+          let error = '';
+          try {
+            contextBridge.transfer(new Uint8Array(new ArrayBuffer(8), 4));
+          } catch (err) {
+            error = err.message;
+          }
+          contextBridge.exposeInMainWorld('example', error);
+        });
+        const result = await callWithBindings((root: any) => root.example);
+        expect(result).to.equal('Only an ArrayBufferView that spans its whole ArrayBuffer can be transferred');
+      });
+
       it('should handle recursive objects', async () => {
         await makeBindingWindow(() => {
           const o: any = { value: 135 };
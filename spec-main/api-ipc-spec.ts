@@ -1,6 +1,8 @@
 import { EventEmitter } from 'events';
 import { expect } from 'chai';
-import { BrowserWindow, ipcMain, IpcMainInvokeEvent, MessageChannelMain, WebContents } from 'electron/main';
+import * as path from 'path';
+import { threadId } from 'worker_threads';
+import { BrowserWindow, ipcMain, IpcMainInvokeEvent, MessageChannelMain, session, WebContents } from 'electron/main';
 import { closeAllWindows } from './window-helpers';
 import { emittedOnce } from './events-helpers';
 
@@ -119,6 +121,110 @@ describe('ipc module', () => {
       const [, { error }] = await emittedOnce(ipcMain, 'result');
       expect(error).to.match(/reply was never sent/);
     });
+
+    describe('handleInWorker', () => {
+      const handlerPath = path.join(__dirname, 'fixtures', 'api', 'ipc-worker-handler.js');
+
+      afterEach(() => {
+        ipcMain.removeHandler('test');
+      });
+
+      it('runs the handler on a worker thread', async () => {
+        ipcMain.handleInWorker('test', handlerPath);
+        const done = emittedOnce(ipcMain, 'result');
+        await w.webContents.executeJavaScript(`(${rendererInvoke})(1, 2)`);
+        const [, { result }] = await done;
+        expect(result.sum).to.equal(3);
+        expect(result.threadId).to.not.equal(threadId);
+      });
+
+      it('spreads calls across threads', async () => {
+        ipcMain.handleInWorker('test', handlerPath, { threads: 2 });
+        const threadIds = await w.webContents.executeJavaScript(`Promise.all([1, 2, 3, 4].map(async i => {
+          const { threadId } = await require('electron').ipcRenderer.invoke('test', i, i);
+          return threadId;
+        }))`);
+        expect(new Set(threadIds).size).to.equal(2);
+      });
+
+      it('receives an error from the handler', async () => {
+        ipcMain.handleInWorker('test', handlerPath);
+        const done = emittedOnce(ipcMain, 'result');
+        await w.webContents.executeJavaScript(`(${rendererInvoke})('throw')`);
+        const [, { error }] = await done;
+        expect(error).to.match(/error from worker/);
+      });
+
+      it('rejects when the handler throws a falsy value', async () => {
+        ipcMain.handleInWorker('test', handlerPath);
+        const done = emittedOnce(ipcMain, 'result');
+        await w.webContents.executeJavaScript(`(${rendererInvoke})('throw-empty')`);
+        const [, { error }] = await done;
+        expect(error).to.be.a('string');
+      });
+
+      it('replaces a worker that exits', async () => {
+        ipcMain.handleInWorker('test', handlerPath);
+        const exited = emittedOnce(ipcMain, 'result');
+        await w.webContents.executeJavaScript(`(${rendererInvoke})('exit')`);
+        const [, { error }] = await exited;
+        expect(error).to.match(/Worker exited with code 1/);
+        const done = emittedOnce(ipcMain, 'result');
+        await w.webContents.executeJavaScript(`(${rendererInvoke})(1, 2)`);
+        const [, { result }] = await done;
+        expect(result.sum).to.equal(3);
+      });
+
+      it('forbids multiple handlers', () => {
+        ipcMain.handle('test', () => {});
+        expect(() => { ipcMain.handleInWorker('test', handlerPath); }).to.throw(/second handler/);
+      });
+
+      it('requires an absolute filename', () => {
+        const relativePath = path.relative(process.cwd(), handlerPath);
+        expect(() => { ipcMain.handleInWorker('test', relativePath); }).to.throw(/absolute path/);
+      });
+    });
+  });
+
+  describe('large payloads', () => {
+    let w = (null as unknown as BrowserWindow);
+
+    before(async () => {
+      w = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false } });
+      await w.loadURL('about:blank');
+    });
+    after(async () => {
+      w.destroy();
+    });
+
+    // Larger than the threshold above which arguments go through shared memory.
+    const size = 8 * 1024 * 1024;
+
+    it('delivers them with send', async () => {
+      const received = emittedOnce(ipcMain, 'large');
+      w.webContents.executeJavaScript(`(() => {
+        const bytes = new Uint8Array(${size});
+        for (let i = 0; i < bytes.length; i++) bytes[i] = i % 251;
+        require('electron').ipcRenderer.send('large', bytes, 'after');
+      })()`);
+      const [, bytes, after] = await received;
+      expect(bytes.length).to.equal(size);
+      expect(bytes[0]).to.equal(0);
+      expect(bytes[size - 1]).to.equal((size - 1) % 251);
+      expect(after).to.equal('after');
+    });
+
+    it('delivers them with invoke', async () => {
+      ipcMain.handleOnce('large', (e, bytes: Uint8Array) => {
+        return bytes.reduce((sum, byte) => sum + byte, 0);
+      });
+      const sum = await w.webContents.executeJavaScript(`(() => {
+        const bytes = new Uint8Array(${size}).fill(1);
+        return require('electron').ipcRenderer.invoke('large', bytes);
+      })()`);
+      expect(sum).to.equal(size);
+    });
   });
 
   describe('ordering', () => {
@@ -196,6 +302,169 @@ describe('ipc module', () => {
       expect(received).to.have.lengthOf(1000);
       expect(received).to.deep.equal([...received].sort((a, b) => a - b));
     });
+
+    it('between sendBatched, send, and sendSync is consistent', async () => {
+      const received: number[] = [];
+      ipcMain.on('test-batched', (e, i) => { received.push(i); });
+      ipcMain.on('test-async', (e, i) => { received.push(i); });
+      ipcMain.on('test-sync', (e, i) => { received.push(i); e.returnValue = null; });
+      const done = new Promise<void>(resolve => ipcMain.once('done', () => { resolve(); }));
+      async function rendererStressTest () {
+        const { ipcRenderer } = require('electron');
+        for (let i = 0; i < 1000; i++) {
+          switch ((Math.random() * 4) | 0) {
+            case 0:
+            case 1:
+              ipcRenderer.sendBatched('test-batched', i);
+              break;
+            case 2:
+              ipcRenderer.send('test-async', i);
+              break;
+            case 3:
+              ipcRenderer.sendSync('test-sync', i);
+              break;
+          }
+          if (i % 100 === 0) await null;
+        }
+        ipcRenderer.sendBatched('done');
+      }
+      try {
+        w.webContents.executeJavaScript(`(${rendererStressTest})()`);
+        await done;
+      } finally {
+        ipcMain.removeAllListeners('test-batched');
+        ipcMain.removeAllListeners('test-async');
+        ipcMain.removeAllListeners('test-sync');
+      }
+      expect(received).to.have.lengthOf(1000);
+      expect(received).to.deep.equal([...received].sort((a, b) => a - b));
+    });
+  });
+
+  describe('shared values', () => {
+    afterEach(closeAllWindows);
+    afterEach(() => {
+      ipcMain.deleteSharedValue('config');
+    });
+
+    const getSharedValue = (w: BrowserWindow) => {
+      return w.webContents.executeJavaScript('require(\'electron\').ipcRenderer.getSharedValue(\'config\')');
+    };
+
+    it('can be read synchronously by renderers', async () => {
+      const w = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false } });
+      await w.loadURL('about:blank');
+      expect(await getSharedValue(w)).to.be.undefined();
+      ipcMain.setSharedValue('config', { theme: 'dark', values: [1, 2, 3] });
+      expect(await getSharedValue(w)).to.deep.equal({ theme: 'dark', values: [1, 2, 3] });
+    });
+
+    it('sees updates, including ones that outgrow the shared memory', async () => {
+      const w = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false } });
+      await w.loadURL('about:blank');
+      ipcMain.setSharedValue('config', 1);
+      expect(await getSharedValue(w)).to.equal(1);
+      ipcMain.setSharedValue('config', 2);
+      expect(await getSharedValue(w)).to.equal(2);
+      const large = 'x'.repeat(64 * 1024);
+      ipcMain.setSharedValue('config', large);
+      expect(await getSharedValue(w)).to.equal(large);
+      ipcMain.deleteSharedValue('config');
+      expect(await getSharedValue(w)).to.be.undefined();
+    });
+
+    it('throws when the value cannot be cloned', () => {
+      expect(() => ipcMain.setSharedValue('config', () => {})).to.throw(/could not be cloned/);
+    });
+
+    it('can be scoped to a session', async () => {
+      const ses = session.fromPartition('shared-values');
+      const w1 = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false, session: ses } });
+      const w2 = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false } });
+      await Promise.all([w1.loadURL('about:blank'), w2.loadURL('about:blank')]);
+      ipcMain.setSharedValue('config', 'secret', { session: ses });
+      expect(await getSharedValue(w1)).to.equal('secret');
+      expect(await getSharedValue(w2)).to.be.undefined();
+    });
+  });
+
+  describe('sendBatched', () => {
+    afterEach(closeAllWindows);
+
+    it('delivers each message with its own event', async () => {
+      const w = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false } });
+      await w.loadURL('about:blank');
+      const received: any[] = [];
+      ipcMain.on('batched', (e, ...args) => {
+        expect(e.sender).to.equal(w.webContents);
+        expect(e.senderFrame).to.equal(w.webContents.mainFrame);
+        received.push(args);
+      });
+      try {
+        const done = emittedOnce(ipcMain, 'done');
+        w.webContents.executeJavaScript(`(${function () {
+          const { ipcRenderer } = require('electron');
+          ipcRenderer.sendBatched('batched', 1);
+          ipcRenderer.sendBatched('batched', 'two', { three: 3 });
+          ipcRenderer.sendBatched('done');
+        }})()`);
+        await done;
+      } finally {
+        ipcMain.removeAllListeners('batched');
+      }
+      expect(received).to.deep.equal([[1], ['two', { three: 3 }]]);
+    });
+
+    it('still delivers the other messages when one cannot be cloned', async () => {
+      const w = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false } });
+      await w.loadURL('about:blank');
+      const received: number[] = [];
+      ipcMain.on('batched', (e, i) => { received.push(i); });
+      try {
+        const done = emittedOnce(ipcMain, 'done');
+        w.webContents.executeJavaScript(`(${function () {
+          const { ipcRenderer } = require('electron');
+          window.onerror = () => true;
+          ipcRenderer.sendBatched('batched', 1);
+          ipcRenderer.sendBatched('batched', () => {});
+          ipcRenderer.sendBatched('batched', 2);
+          ipcRenderer.sendBatched('done');
+        }})()`);
+        await done;
+      } finally {
+        ipcMain.removeAllListeners('batched');
+      }
+      expect(received).to.deep.equal([1, 2]);
+    });
+
+    it('drops malformed entries of a batch', async () => {
+      const w = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false } });
+      await w.loadURL('about:blank');
+      const received: any[] = [];
+      ipcMain.on('batched', (e, ...args) => { received.push(args); });
+      try {
+        const done = emittedOnce(ipcMain, 'done');
+        w.webContents.executeJavaScript(`(${function () {
+          const { ipc } = (process as any)._linkedBinding('electron_renderer_ipc');
+          ipc.send(true, 'BROWSER_BATCHED_MESSAGES', ['not a batch']);
+          ipc.send(true, 'BROWSER_BATCHED_MESSAGES', []);
+          ipc.send(true, 'BROWSER_BATCHED_MESSAGES', [[
+            ['batched', [1]],
+            'batched',
+            null,
+            [42, [2]],
+            ['batched', 3],
+            ['batched', [4], 'extra'],
+            ['batched', [5]]
+          ]]);
+          ipc.send(false, 'done', []);
+        }})()`);
+        await done;
+      } finally {
+        ipcMain.removeAllListeners('batched');
+      }
+      expect(received).to.deep.equal([[1], [5]]);
+    });
   });
 
   describe('MessagePort', () => {
@@ -278,6 +547,111 @@ describe('ipc module', () => {
       expect(data).to.equal('a message');
     });
 
+    it('can transfer an ArrayBuffer to the main process', async () => {
+      const w = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false } });
+      w.loadURL('about:blank');
+      const p = emittedOnce(ipcMain, 'buffer');
+      const byteLength = await w.webContents.executeJavaScript(`(${function () {
+        const buffer = new Uint8Array([1, 2, 3]).buffer;
+        require('electron').ipcRenderer.postMessage('buffer', { buffer }, [buffer]);
+        return buffer.byteLength;
+      }})()`);
+      expect(byteLength).to.equal(0);
+      const [, msg] = await p;
+      expect(msg.buffer).to.be.an.instanceOf(ArrayBuffer);
+      expect([...new Uint8Array(msg.buffer)]).to.deep.equal([1, 2, 3]);
+    });
+
+    it('can transfer an ArrayBuffer to a renderer', async () => {
+      const w = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false } });
+      await w.loadURL('about:blank');
+      const received = w.webContents.executeJavaScript(`new Promise(resolve => {
+        require('electron').ipcRenderer.once('buffer', (e, msg) => {
+          resolve([...new Uint8Array(msg.buffer)]);
+        });
+      })`);
+      const buffer = new Uint8Array([4, 5, 6]).buffer;
+      w.webContents.postMessage('buffer', { buffer }, [buffer]);
+      expect(buffer.byteLength).to.equal(0);
+      expect(await received).to.deep.equal([4, 5, 6]);
+    });
+
+    describe('ipcRenderer.connectTo', () => {
+      it('connects two renderers directly once allowed', async () => {
+        const w1 = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false } });
+        const w2 = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false } });
+        await Promise.all([w1.loadURL('about:blank'), w2.loadURL('about:blank')]);
+        w1.webContents.once('ipc-renderer-connect-to' as any, (event: Electron.Event, target: WebContents, channel: string, callback: (allow: boolean) => void) => {
+          expect(target).to.equal(w2.webContents);
+          expect(channel).to.equal('connect');
+          callback(true);
+        });
+        const received = w2.webContents.executeJavaScript(`new Promise(resolve => {
+          require('electron').ipcRenderer.once('connect', (e, ...args) => {
+            const [port] = e.ports;
+            port.onmessage = ({ data }) => resolve({ senderId: e.senderId, args, data });
+          });
+        })`);
+        await w1.webContents.executeJavaScript(`(async () => {
+          const port = await require('electron').ipcRenderer.connectTo(${w2.webContents.id}, 'connect');
+          port.postMessage('hello');
+        })()`);
+        expect(await received).to.deep.equal({ senderId: w1.webContents.id, args: [], data: 'hello' });
+      });
+
+      it('is refused when nothing allows it', async () => {
+        const w1 = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false } });
+        const w2 = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false } });
+        await Promise.all([w1.loadURL('about:blank'), w2.loadURL('about:blank')]);
+        await expect(w1.webContents.executeJavaScript(
+          `require('electron').ipcRenderer.connectTo(${w2.webContents.id}, 'connect')`
+        )).to.eventually.be.rejectedWith(/was refused/);
+      });
+
+      it('can be refused by the main process', async () => {
+        const w1 = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false } });
+        const w2 = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false } });
+        await Promise.all([w1.loadURL('about:blank'), w2.loadURL('about:blank')]);
+        w1.webContents.once('ipc-renderer-connect-to' as any, (event: Electron.Event, target: WebContents, channel: string, callback: (allow: boolean) => void) => {
+          callback(false);
+        });
+        await expect(w1.webContents.executeJavaScript(
+          `require('electron').ipcRenderer.connectTo(${w2.webContents.id}, 'connect')`
+        )).to.eventually.be.rejectedWith(/was refused/);
+      });
+
+      it('rejects when the target is destroyed before the request is answered', async () => {
+        const w1 = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false } });
+        const w2 = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false } });
+        await Promise.all([w1.loadURL('about:blank'), w2.loadURL('about:blank')]);
+        const targetId = w2.webContents.id;
+        w1.webContents.once('ipc-renderer-connect-to' as any, () => {
+          w2.destroy();
+        });
+        await expect(w1.webContents.executeJavaScript(
+          `require('electron').ipcRenderer.connectTo(${targetId}, 'connect')`
+        )).to.eventually.be.rejectedWith(new RegExp(`No WebContents with id ${targetId}`));
+      });
+
+      it('rejects for an unknown web contents', async () => {
+        const w = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false } });
+        await w.loadURL('about:blank');
+        await expect(w.webContents.executeJavaScript(
+          'require(\'electron\').ipcRenderer.connectTo(12345, \'connect\')'
+        )).to.eventually.be.rejectedWith(/No WebContents with id 12345/);
+      });
+    });
+
+    it('throws when transferring the same ArrayBuffer twice', async () => {
+      const w = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false } });
+      await w.loadURL('about:blank');
+      const buffer = new ArrayBuffer(8);
+      expect(() => {
+        w.webContents.postMessage('buffer', buffer, [buffer, buffer]);
+      }).to.throw(/is a duplicate of an earlier ArrayBuffer/);
+      expect(buffer.byteLength).to.equal(8);
+    });
+
     describe('close event', () => {
       describe('in renderer', () => {
         it('is emitted when the main process closes its end of the port', async () => {
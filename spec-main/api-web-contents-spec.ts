@@ -47,6 +47,36 @@ describe('webContents module', () => {
     });
   });
 
+  describe('broadcast()', () => {
+    afterEach(closeAllWindows);
+
+    const listen = (w: BrowserWindow) => w.webContents.executeJavaScript(`new Promise(resolve => {
+      require('electron').ipcRenderer.once('broadcast', (e, ...args) => resolve(args));
+    })`);
+
+    it('sends the value to every web contents', async () => {
+      const windows = [1, 2, 3].map(() => new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false } }));
+      await Promise.all(windows.map(w => w.loadURL('about:blank')));
+      const received = Promise.all(windows.map(listen));
+      await Promise.all(windows.map(w => w.webContents.executeJavaScript('null')));
+      expect(webContents.broadcast('broadcast', { hello: 'world' })).to.be.at.least(3);
+      expect(await received).to.deep.equal(windows.map(() => [{ hello: 'world' }]));
+    });
+
+    it('can be limited to one session', async () => {
+      const w1 = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false } });
+      const w2 = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false, partition: 'broadcast' } });
+      await Promise.all([w1.loadURL('about:blank'), w2.loadURL('about:blank')]);
+      const received = listen(w2);
+      expect(webContents.broadcast('broadcast', 42, { session: w2.webContents.session })).to.equal(1);
+      expect(await received).to.deep.equal([42]);
+    });
+
+    it('throws when the value cannot be cloned', () => {
+      expect(() => webContents.broadcast('broadcast', () => {})).to.throw(/could not be cloned/);
+    });
+  });
+
   describe('will-prevent-unload event', function () {
     afterEach(closeAllWindows);
     it('does not emit if beforeunload returns undefined in a BrowserWindow', async () => {
@@ -1,9 +1,14 @@
 import { expect } from 'chai';
+import * as childProcess from 'child_process';
+import * as fs from 'fs';
+import * as os from 'os';
 import * as path from 'path';
 import * as url from 'url';
 import { BrowserWindow, ipcMain } from 'electron/main';
+import { nativeImage } from 'electron/common';
 import { closeAllWindows } from './window-helpers';
 import { emittedOnce } from './events-helpers';
+import { ifit } from './spec-helpers';
 
 describe('asar package', () => {
   const fixtures = path.join(__dirname, '..', 'spec', 'fixtures');
@@ -108,4 +113,242 @@ describe('asar package', () => {
       expect(result).to.equal('success');
     });
   });
+
+  describe('header index', () => {
+    const archive = path.join(asarDir, 'a.asar');
+
+    it('lists directory entries in name order', () => {
+      expect(fs.readdirSync(archive)).to.deep.equal([
+        'dir1', 'dir2', 'dir3', 'file1', 'file2', 'file3', 'link1', 'link2', 'ping.js'
+      ]);
+      expect(fs.readdirSync(path.join(archive, 'dir2'))).to.deep.equal(['file1', 'file2', 'file3']);
+    });
+
+    it('looks up nested files', () => {
+      for (const dir of ['dir1', 'dir2', 'dir3']) {
+        for (const file of ['file1', 'file2', 'file3']) {
+          expect(fs.readFileSync(path.join(archive, dir, file), 'utf8')).to.equal(`${file}\n`);
+        }
+      }
+    });
+
+    it('follows links in intermediate components', () => {
+      expect(fs.readFileSync(path.join(archive, 'link2', 'file2'), 'utf8')).to.equal('file2\n');
+      expect(fs.readFileSync(path.join(archive, 'dir1', 'link2', 'link2', 'file3'), 'utf8')).to.equal('file3\n');
+      expect(fs.statSync(path.join(archive, 'link2')).isDirectory()).to.be.true('link2 is not a directory');
+    });
+
+    it('does not follow a link in the last component when asked not to', () => {
+      expect(fs.lstatSync(path.join(archive, 'link1')).isSymbolicLink()).to.be.true('link1 is not a link');
+      expect(fs.lstatSync(path.join(archive, 'dir1', 'link2')).isSymbolicLink()).to.be.true('dir1/link2 is not a link');
+      expect(fs.statSync(path.join(archive, 'dir1', 'link1')).isFile()).to.be.true('dir1/link1 is not a file');
+    });
+
+    it('accepts a trailing separator on directories', () => {
+      const dir = path.join(archive, 'dir1') + path.sep;
+      expect(fs.statSync(dir).isDirectory()).to.be.true('dir1/ is not a directory');
+      expect(fs.readdirSync(dir)).to.deep.equal(['file1', 'file2', 'file3', 'link1', 'link2']);
+    });
+
+    it('does not find missing entries', () => {
+      expect(fs.existsSync(path.join(archive, 'file4'))).to.be.false();
+      expect(fs.existsSync(path.join(archive, 'dir4', 'file1'))).to.be.false();
+      expect(fs.existsSync(path.join(archive, 'file1', 'file1'))).to.be.false();
+      expect(fs.existsSync(path.join(archive, 'dir'))).to.be.false();
+      expect(fs.existsSync(path.join(archive, 'dir10'))).to.be.false();
+    });
+  });
+
+  describe('--asar-write-index', () => {
+    const appPath = path.join(__dirname, 'fixtures', 'apps', 'asar-index', 'main.js');
+    let tmpDir: string;
+
+    beforeEach(() => {
+      tmpDir = fs.mkdtempSync(path.join(os.tmpdir(), 'electron-asar-index-'));
+    });
+
+    afterEach(() => {
+      fs.rmdirSync(tmpDir, { recursive: true });
+    });
+
+    const lookUp = async (archive: string, args: string[] = []) => {
+      const appProcess = childProcess.spawn(process.execPath, [appPath, ...args], {
+        env: { ...process.env, ASAR_INDEX_ARCHIVE: archive }
+      });
+      let stdout = '';
+      appProcess.stdout.on('data', (data) => { stdout += data; });
+      const [code] = await emittedOnce(appProcess, 'close');
+      expect(code).to.equal(0);
+      return JSON.parse(stdout);
+    };
+
+    const expected = {
+      root: ['dir1', 'dir2', 'dir3', 'file1', 'file2', 'file3', 'link1', 'link2', 'ping.js'],
+      dir1: ['file1', 'file2', 'file3', 'link1', 'link2'],
+      file1: 'file1\n'
+    };
+
+    it('writes an index that later launches use', async () => {
+      const archive = path.join(tmpDir, 'a.asar');
+      fs.copyFileSync(path.join(asarDir, 'a.asar'), archive);
+
+      expect(await lookUp(archive, ['--asar-write-index'])).to.deep.equal(expected);
+      expect(fs.existsSync(`${archive}.index`)).to.be.true('index was not written');
+
+      expect(await lookUp(archive)).to.deep.equal(expected);
+    });
+
+    it('ignores an index built from another archive', async () => {
+      const other = path.join(tmpDir, 'other.asar');
+      fs.copyFileSync(path.join(asarDir, 'web.asar'), other);
+      await lookUp(other, ['--asar-write-index']);
+
+      const archive = path.join(tmpDir, 'a.asar');
+      fs.copyFileSync(path.join(asarDir, 'a.asar'), archive);
+      fs.copyFileSync(`${other}.index`, `${archive}.index`);
+
+      expect(await lookUp(archive)).to.deep.equal(expected);
+    });
+  });
+
+  describe('archive mapping', () => {
+    let tmpDir: string;
+
+    beforeEach(() => {
+      tmpDir = fs.mkdtempSync(path.join(os.tmpdir(), 'electron-asar-mapping-'));
+    });
+
+    afterEach(() => {
+      // The archives stay open for the lifetime of the process, which keeps
+      // Windows from deleting them.
+      try {
+        fs.rmdirSync(tmpDir, { recursive: true });
+      } catch {}
+    });
+
+    const copyArchive = (name: string) => {
+      const copy = path.join(tmpDir, name);
+      fs.copyFileSync(path.join(asarDir, name), copy);
+      return copy;
+    };
+
+    const isMapped = (archive: string) => {
+      return fs.readFileSync('/proc/self/maps', 'utf8').includes(archive);
+    };
+
+    it('reads packed files with fs', () => {
+      const archive = copyArchive('a.asar');
+      expect(fs.readFileSync(path.join(archive, 'file1'), 'utf8')).to.equal('file1\n');
+      expect(fs.readFileSync(path.join(archive, 'dir1', 'file2'), 'utf8')).to.equal('file2\n');
+      if (process.platform === 'linux') expect(isMapped(archive)).to.be.true('archive is not mapped');
+    });
+
+    it('extracts packed files', () => {
+      const archive = copyArchive('a.asar');
+      const fd = fs.openSync(path.join(archive, 'file3'), 'r');
+      try {
+        const buffer = Buffer.alloc(16);
+        const length = fs.readSync(fd, buffer, 0, buffer.length, 0);
+        expect(buffer.slice(0, length).toString()).to.equal('file3\n');
+      } finally {
+        fs.closeSync(fd);
+      }
+    });
+
+    it('decodes packed images', () => {
+      const archive = copyArchive('logo.asar');
+      const expected = nativeImage.createFromPath(path.join(asarDir, 'logo.asar', 'logo.png'));
+      const image = nativeImage.createFromPath(path.join(archive, 'logo.png'));
+      expect(image.isEmpty()).to.be.false('image is empty');
+      expect(image.toBitmap().equals(expected.toBitmap())).to.be.true('bitmaps differ');
+    });
+
+    it('serves packed files over file:', async () => {
+      const archive = copyArchive('a.asar');
+      const w = new BrowserWindow({ show: false });
+      await w.loadFile(path.join(archive, 'file1'));
+      expect(await w.webContents.executeJavaScript('document.body.textContent')).to.equal('file1\n');
+    });
+
+    // Windows doesn't allow truncating a mapped file.
+    ifit(process.platform !== 'win32')('fails reads of an archive truncated after it was mapped', () => {
+      const archive = copyArchive('logo.asar');
+      expect(nativeImage.createFromPath(path.join(archive, 'logo.png')).isEmpty()).to.be.false('image is empty');
+      fs.truncateSync(archive, 16);
+      expect(nativeImage.createFromPath(path.join(archive, 'logo.png')).isEmpty()).to.be.true('image is not empty');
+    });
+  });
+
+  describe('--asar-extract-mode', () => {
+    const appPath = path.join(__dirname, 'fixtures', 'apps', 'asar-extract-mode', 'main.js');
+    const archive = path.join(asarDir, 'a.asar');
+    let cacheDir: string;
+
+    beforeEach(() => {
+      cacheDir = fs.mkdtempSync(path.join(os.tmpdir(), 'electron-asar-cache-'));
+    });
+
+    afterEach(() => {
+      fs.rmdirSync(cacheDir, { recursive: true });
+    });
+
+    const extract = async (mode: string) => {
+      const appProcess = childProcess.spawn(process.execPath, [appPath, `--asar-extract-mode=${mode}`], {
+        env: { ...process.env, ASAR_EXTRACT_ARCHIVE: archive, ASAR_EXTRACT_CACHE_DIR: cacheDir }
+      });
+      let stdout = '';
+      appProcess.stdout.on('data', (data) => { stdout += data; });
+      const [code] = await emittedOnce(appProcess, 'close');
+      expect(code).to.equal(0);
+      return JSON.parse(stdout);
+    };
+
+    const listCache = () => {
+      const root = path.join(cacheDir, 'AsarCache');
+      return fs.readdirSync(root).map(entry => path.join(root, entry, 'file1'));
+    };
+
+    ifit(process.platform === 'linux')('extracts files to anonymous memory in memory mode', async () => {
+      const result = await extract('memory');
+      expect(result.contents).to.equal('file1\n');
+      expect(result.target).to.match(/^\/memfd:/);
+      expect(fs.existsSync(path.join(cacheDir, 'AsarCache'))).to.be.false();
+    });
+
+    it('reuses the cached copy in cache mode', async () => {
+      const first = await extract('cache');
+      expect(first.contents).to.equal('file1\n');
+      const [cached] = listCache();
+      expect(fs.readFileSync(cached, 'utf8')).to.equal('file1\n');
+      if (process.platform === 'linux') expect(first.target).to.equal(cached);
+
+      const { mtimeMs } = fs.statSync(cached);
+      const second = await extract('cache');
+      expect(second.contents).to.equal('file1\n');
+      expect(listCache()).to.deep.equal([cached]);
+      expect(fs.statSync(cached).mtimeMs).to.equal(mtimeMs);
+    });
+
+    it('replaces a cached copy that was modified in cache mode', async () => {
+      await extract('cache');
+      const [cached] = listCache();
+      fs.writeFileSync(cached, 'FILE1\n');
+
+      const result = await extract('cache');
+      expect(result.contents).to.equal('file1\n');
+      expect(fs.readFileSync(cached, 'utf8')).to.equal('file1\n');
+    });
+
+    it('removes entries that were not used for a long time in cache mode', async () => {
+      const stale = path.join(cacheDir, 'AsarCache', 'stale');
+      fs.mkdirSync(stale, { recursive: true });
+      fs.writeFileSync(path.join(stale, 'file1'), 'stale');
+      const longAgo = new Date(Date.now() - 60 * 24 * 60 * 60 * 1000);
+      fs.utimesSync(stale, longAgo, longAgo);
+
+      await extract('cache');
+      expect(fs.existsSync(stale)).to.be.false();
+      expect(listCache()).to.have.lengthOf(1);
+    });
+  });
 });
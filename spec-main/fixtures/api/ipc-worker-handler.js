@@ -0,0 +1,15 @@
+const { threadId } = require('worker_threads');
+
+module.exports = async (a, b) => {
+  if (a === 'throw') {
+    throw new Error('error from worker');
+  }
+  if (a === 'throw-empty') {
+    // eslint-disable-next-line no-throw-literal
+    throw '';
+  }
+  if (a === 'exit') {
+    process.exit(1);
+  }
+  return { sum: a + b, threadId };
+};
@@ -0,0 +1,20 @@
+const { app } = require('electron');
+const fs = require('fs');
+const path = require('path');
+
+// Extracts a file from an archive by opening it, and reports where the
+// extracted copy lives and what it contains.
+app.setPath('userCache', process.env.ASAR_EXTRACT_CACHE_DIR);
+
+const filePath = path.join(process.env.ASAR_EXTRACT_ARCHIVE, 'file1');
+const fd = fs.openSync(filePath, 'r');
+const buffer = Buffer.alloc(64);
+const length = fs.readSync(fd, buffer, 0, buffer.length, 0);
+const result = { contents: buffer.slice(0, length).toString() };
+if (process.platform === 'linux') {
+  result.target = fs.readlinkSync(`/proc/self/fd/${fd}`);
+}
+fs.closeSync(fd);
+
+process.stdout.write(JSON.stringify(result));
+app.exit(0);
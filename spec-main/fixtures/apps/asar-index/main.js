@@ -0,0 +1,21 @@
+const { app } = require('electron');
+const fs = require('fs');
+const path = require('path');
+
+// Looks up a few entries of an archive and reports what it found.
+const archive = process.env.ASAR_INDEX_ARCHIVE;
+const attempt = (fn) => {
+  try {
+    return fn();
+  } catch {
+    return null;
+  }
+};
+const result = {
+  root: attempt(() => fs.readdirSync(archive)),
+  dir1: attempt(() => fs.readdirSync(path.join(archive, 'dir1'))),
+  file1: attempt(() => fs.readFileSync(path.join(archive, 'dir1', 'file1'), 'utf8'))
+};
+
+process.stdout.write(JSON.stringify(result));
+app.exit(0);
@@ -0,0 +1,32 @@
+const { app } = require('electron');
+const fs = require('fs');
+const net = require('net');
+const util = require('util');
+
+// Exercises timers, the libuv thread pool and sockets in the browser process.
+async function run () {
+  await util.promisify(setTimeout)(10);
+  await fs.promises.readFile(__filename);
+
+  const server = net.createServer(socket => socket.pipe(socket));
+  await new Promise(resolve => server.listen(0, '127.0.0.1', resolve));
+  const echoed = await new Promise((resolve, reject) => {
+    const client = net.connect(server.address().port, '127.0.0.1', () => {
+      client.end('ping');
+    });
+    let data = '';
+    client.on('data', chunk => { data += chunk; });
+    client.on('end', () => resolve(data));
+    client.on('error', reject);
+  });
+  server.close();
+
+  if (echoed !== 'ping') throw new Error(`Unexpected echo: ${echoed}`);
+}
+
+app.whenReady().then(run).then(() => {
+  app.exit(0);
+}, (error) => {
+  console.error(error);
+  app.exit(1);
+});
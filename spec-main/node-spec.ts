@@ -34,6 +34,15 @@ describe('node feature', () => {
     expect(code).to.equal(0);
   });
 
+  ifit(process.platform === 'linux')('runs libuv without the embed thread when ElectronUvFdWatcher is enabled', async () => {
+    const appPath = path.join(mainFixturesPath, 'apps', 'libuv-fd-watcher', 'main.js');
+    const appProcess = childProcess.spawn(process.execPath, [appPath, '--enable-features=ElectronUvFdWatcher'], {
+      stdio: 'inherit'
+    });
+    const [code] = await emittedOnce(appProcess, 'close');
+    expect(code).to.equal(0);
+  });
+
   describe('contexts', () => {
     describe('setTimeout called under Chromium event loop in browser process', () => {
       it('Can be scheduled in time', (done) => {
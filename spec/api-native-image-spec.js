@@ -183,6 +183,35 @@ describe('nativeImage module', () => {
       expect(() => nativeImage.createFromBitmap(Buffer.from([]), {})).to.throw('width is required');
       expect(() => nativeImage.createFromBitmap(Buffer.from([]), { width: 1 })).to.throw('height is required');
       expect(() => nativeImage.createFromBitmap(Buffer.from([]), { width: 1, height: 1 })).to.throw('invalid buffer size');
+      expect(() => nativeImage.createFromBitmap(Buffer.alloc(4), { width: 1, height: 1, colorType: 'argb' })).to.throw("colorType must be 'bgra' or 'rgba'");
+      expect(() => nativeImage.createFromBitmap(Buffer.alloc(4), { width: 1, height: 1, alphaType: 'opaque' })).to.throw("alphaType must be 'premultiplied' or 'unpremultiplied'");
+    });
+
+    it('uses the memory of the buffer when copy is false', () => {
+      const buffer = Buffer.from([1, 2, 3, 255]);
+      const image = nativeImage.createFromBitmap(buffer, { width: 1, height: 1, copy: false });
+      expect(image.toBitmap().equals(buffer)).to.be.true();
+      expect(image.toBitmap({ copy: false }).equals(buffer)).to.be.true();
+    });
+
+    it('converts from the given color type', () => {
+      const imageA = nativeImage.createFromPath(path.join(__dirname, 'fixtures', 'assets', 'logo.png'));
+      const rgba = imageA.toBitmap({ colorType: 'rgba' });
+      const imageB = nativeImage.createFromBitmap(rgba, { ...imageA.getSize(), colorType: 'rgba' });
+      expect(imageB.toBitmap().equals(imageA.toBitmap())).to.be.true();
+    });
+  });
+
+  describe('toBitmap(options)', () => {
+    it('returns the same data when copy is false', () => {
+      const image = nativeImage.createFromPath(path.join(__dirname, 'fixtures', 'assets', 'logo.png'));
+      expect(image.toBitmap({ copy: false }).equals(image.toBitmap())).to.be.true();
+    });
+
+    it('converts to the requested color type', () => {
+      const image = nativeImage.createFromBitmap(Buffer.from([1, 2, 3, 255]), { width: 1, height: 1, colorType: 'bgra' });
+      expect([...image.toBitmap({ colorType: 'bgra' })]).to.deep.equal([1, 2, 3, 255]);
+      expect([...image.toBitmap({ colorType: 'rgba' })]).to.deep.equal([3, 2, 1, 255]);
     });
   });
 
@@ -339,6 +368,52 @@ describe('nativeImage module', () => {
     });
   });
 
+  describe('toPNGAsync()', () => {
+    it('resolves with the same data as toPNG()', async () => {
+      const image = nativeImage.createFromPath(path.join(__dirname, 'fixtures', 'assets', 'logo.png'));
+      const resized = image.resize({ width: 100 });
+      expect((await resized.toPNGAsync()).equals(resized.toPNG())).to.be.true();
+      expect((await resized.toPNGAsync({ scaleFactor: 2.0 })).equals(resized.toPNG({ scaleFactor: 2.0 }))).to.be.true();
+    });
+
+    it('resolves with an empty buffer for an empty image', async () => {
+      expect(await nativeImage.createEmpty().toPNGAsync()).to.have.lengthOf(0);
+    });
+  });
+
+  describe('toJPEGAsync()', () => {
+    it('resolves with the same data as toJPEG()', async () => {
+      const image = nativeImage.createFromPath(path.join(__dirname, 'fixtures', 'assets', 'logo.png'));
+      expect((await image.toJPEGAsync(80)).equals(image.toJPEG(80))).to.be.true();
+    });
+  });
+
+  describe('createFromPathAsync(path)', () => {
+    it('resolves with the image at the path', async () => {
+      const imagePath = path.join(__dirname, 'fixtures', 'assets', 'logo.png');
+      const image = await nativeImage.createFromPathAsync(imagePath);
+      expect(image.getSize()).to.deep.equal({ width: 538, height: 190 });
+      expect(image.toBitmap().equals(nativeImage.createFromPath(imagePath).toBitmap())).to.be.true();
+    });
+
+    it('resolves with an empty image for invalid paths', async () => {
+      expect((await nativeImage.createFromPathAsync('does-not-exist.png')).isEmpty()).to.be.true();
+      expect((await nativeImage.createFromPathAsync(__filename)).isEmpty()).to.be.true();
+    });
+  });
+
+  describe('createFromBufferAsync(buffer, options)', () => {
+    it('decodes PNG data', async () => {
+      const imageA = nativeImage.createFromPath(path.join(__dirname, 'fixtures', 'assets', 'logo.png'));
+      const imageB = await nativeImage.createFromBufferAsync(imageA.toPNG(), { scaleFactor: 2.0 });
+      expect(imageB.getSize()).to.deep.equal({ width: 269, height: 95 });
+    });
+
+    it('throws for non-buffers', () => {
+      expect(() => nativeImage.createFromBufferAsync('not a buffer')).to.throw('buffer must be a node Buffer');
+    });
+  });
+
   describe('createFromPath(path)', () => {
     it('returns an empty image for invalid paths', () => {
       expect(nativeImage.createFromPath('').isEmpty()).to.be.true();
@@ -446,6 +521,23 @@ describe('nativeImage module', () => {
     });
   });
 
+  describe('resizeAsync(options)', () => {
+    it('resolves with the same image as resize()', async () => {
+      const image = nativeImage.createFromPath(path.join(__dirname, 'fixtures', 'assets', 'logo.png'));
+      const options = [{ width: 269 }, { height: 200 }, { width: 80, height: 65, quality: 'good' }];
+      const resized = await Promise.all(options.map((o) => image.resizeAsync(o)));
+      resized.forEach((result, i) => {
+        expect(result.toBitmap().equals(image.resize(options[i]).toBitmap())).to.be.true();
+      });
+    });
+
+    it('resolves with an empty image for empty sizes', async () => {
+      const image = nativeImage.createFromPath(path.join(__dirname, 'fixtures', 'assets', 'logo.png'));
+      expect((await image.resizeAsync({ width: 0, height: 0 })).isEmpty()).to.be.true();
+      expect((await nativeImage.createEmpty().resizeAsync({ width: 1, height: 1 })).isEmpty()).to.be.true();
+    });
+  });
+
   describe('crop(bounds)', () => {
     it('returns an empty image when called on an empty image', () => {
       expect(nativeImage.createEmpty().crop({ width: 1, height: 2, x: 0, y: 0 }).isEmpty()).to.be.true();
@@ -22,6 +22,24 @@ async function expectToThrowErrorWithCode (func, code) {
   expect(error).to.have.property('code').which.equals(code);
 }
 
+// Writes an archive with the given header |files| followed by |content| to a
+// temporary directory, and returns its path.
+function writeArchive (files, content) {
+  const header = JSON.stringify({ files });
+  const headerLength = Buffer.byteLength(header);
+  const headerPickle = Buffer.alloc(8 + Math.ceil(headerLength / 4) * 4);
+  headerPickle.writeUInt32LE(headerPickle.length - 4, 0);
+  headerPickle.writeUInt32LE(headerLength, 4);
+  headerPickle.write(header, 8);
+  const sizePickle = Buffer.alloc(8);
+  sizePickle.writeUInt32LE(4, 0);
+  sizePickle.writeUInt32LE(headerPickle.length, 4);
+
+  const archivePath = path.join(temp.mkdirSync('asar'), 'test.asar');
+  fs.writeFileSync(archivePath, Buffer.concat([sizePickle, headerPickle, content]));
+  return archivePath;
+}
+
 describe('asar package', function () {
   const fixtures = path.join(__dirname, 'fixtures');
   const asarDir = path.join(fixtures, 'test.asar');
@@ -1453,6 +1471,80 @@ describe('asar package', function () {
       });
     });
 
+    describe('internalModuleStat', function () {
+      const { internalModuleStat } = process.binding('fs');
+
+      it('reports files, directories and missing paths', function () {
+        const p = path.join(asarDir, 'a.asar');
+        expect(internalModuleStat(path.join(p, 'file1'))).to.equal(0);
+        expect(internalModuleStat(path.join(p, 'dir1'))).to.equal(1);
+        expect(internalModuleStat(path.join(p, 'ping'))).to.equal(-34);
+      });
+
+      it('answers repeated and prefetched probes consistently', function () {
+        const p = path.join(asarDir, 'a.asar');
+        expect(internalModuleStat(path.join(p, 'ping'))).to.equal(-34);
+        expect(internalModuleStat(path.join(p, 'ping.js'))).to.equal(0);
+        expect(internalModuleStat(path.join(p, 'ping.json'))).to.equal(-34);
+        expect(internalModuleStat(path.join(p, 'dir1', 'index.js'))).to.equal(-34);
+      });
+
+      it('keeps answering correctly after many missing paths', function () {
+        const p = path.join(asarDir, 'a.asar');
+        for (let i = 0; i < 10000; i++) {
+          expect(internalModuleStat(path.join(p, `missing${i}`))).to.equal(-34);
+        }
+        expect(internalModuleStat(path.join(p, 'file1'))).to.equal(0);
+        expect(internalModuleStat(path.join(p, 'dir1'))).to.equal(1);
+        expect(internalModuleStat(path.join(p, 'missing0'))).to.equal(-34);
+      });
+    });
+
+    describe('compressed entries', function () {
+      const zlib = require('zlib');
+      const blockSize = 1024;
+      const content = Buffer.from('0123456789abcdef'.repeat(300));
+      let archivePath;
+
+      before(function () {
+        // Packs |content| as brotli blocks, the way the packer lays them out.
+        const blocks = [];
+        for (let i = 0; i < content.length; i += blockSize) {
+          blocks.push(zlib.brotliCompressSync(content.slice(i, i + blockSize)));
+        }
+        archivePath = writeArchive({
+          'file.txt': {
+            size: content.length,
+            offset: '0',
+            compression: {
+              algorithm: 'brotli',
+              blockSize,
+              blocks: blocks.map(block => block.length)
+            }
+          }
+        }, Buffer.concat(blocks));
+      });
+
+      it('reports the uncompressed size', function () {
+        expect(fs.statSync(path.join(archivePath, 'file.txt')).size).to.equal(content.length);
+      });
+
+      it('decompresses with fs.readFileSync', function () {
+        expect(fs.readFileSync(path.join(archivePath, 'file.txt'))).to.deep.equal(content);
+      });
+
+      it('decompresses with fs.readFile', async function () {
+        const buffer = await fs.promises.readFile(path.join(archivePath, 'file.txt'));
+        expect(buffer).to.deep.equal(content);
+      });
+
+      it('decompresses when the file is copied out', function () {
+        const dest = temp.path();
+        fs.copyFileSync(path.join(archivePath, 'file.txt'), dest);
+        expect(fs.readFileSync(dest)).to.deep.equal(content);
+      });
+    });
+
     describe('util.promisify', function () {
       it('can promisify all fs functions', function () {
         const originalFs = require('original-fs');
@@ -1647,6 +1739,53 @@ describe('asar package', function () {
       });
     });
 
+    describe('with integrity hashes', function () {
+      const crypto = require('crypto');
+      const blockSize = 1024;
+      const content = Buffer.from('integrity'.repeat(500));
+      const sha256 = (data) => crypto.createHash('sha256').update(data).digest('hex');
+      const integrityOf = (data) => {
+        const blocks = [];
+        for (let i = 0; i < data.length; i += blockSize) {
+          blocks.push(sha256(data.slice(i, i + blockSize)));
+        }
+        return { algorithm: 'SHA256', hash: sha256(data), blockSize, blocks };
+      };
+
+      let archivePath;
+      before(function () {
+        const corrupted = Buffer.from(content);
+        corrupted[content.length - 1] ^= 1;
+        archivePath = writeArchive({
+          'good.txt': { size: content.length, offset: '0', integrity: integrityOf(content) },
+          'bad.txt': { size: content.length, offset: String(content.length), integrity: integrityOf(content) }
+        }, Buffer.concat([content, corrupted]));
+      });
+
+      it('serves files matching their hashes', function (done) {
+        $.get('file://' + path.join(archivePath, 'good.txt'), function (data) {
+          try {
+            expect(data).to.equal(content.toString());
+            done();
+          } catch (e) {
+            done(e);
+          }
+        });
+      });
+
+      it('fails the request when a block does not match', function (done) {
+        $.ajax({
+          url: 'file://' + path.join(archivePath, 'bad.txt'),
+          success: function () {
+            done(new Error('Corrupted file was served'));
+          },
+          error: function () {
+            done();
+          }
+        });
+      });
+    });
+
     it('gets 404 when file is not found', function (done) {
       const p = path.resolve(asarDir, 'a.asar', 'no-exist');
       $.ajax({
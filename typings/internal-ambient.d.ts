@@ -37,7 +37,8 @@ declare namespace NodeJS {
     sendToHost(channel: string, args: any[]): void;
     sendTo(internal: boolean, webContentsId: number, channel: string, args: any[]): void;
     invoke<T>(internal: boolean, channel: string, args: any[]): Promise<{ error: string, result: T }>;
-    postMessage(channel: string, message: any, transferables: MessagePort[]): void;
+    postMessage(channel: string, message: any, transferables: (MessagePort | ArrayBuffer)[]): void;
+    getSharedValue(key: string): any;
   }
 
   interface V8UtilBinding {
@@ -64,6 +65,7 @@ declare namespace NodeJS {
     size: number;
     unpacked: boolean;
     offset: number;
+    compressed: boolean;
   };
 
   type AsarFileStat = {
@@ -78,9 +80,12 @@ declare namespace NodeJS {
     readonly path: string;
     getFileInfo(path: string): AsarFileInfo | false;
     stat(path: string): AsarFileStat | false;
+    statBatch(paths: string[]): Float64Array;
     readdir(path: string): string[] | false;
     realpath(path: string): string | false;
     copyFileOut(path: string): string | false;
+    read(path: string): Buffer | false;
+    readAsync(path: string): Promise<Buffer | false>;
     getFd(): number | -1;
   }
 
@@ -234,6 +239,10 @@ declare namespace NodeJS {
     _linkedBinding(name: 'electron_browser_power_monitor'): PowerMonitorBinding;
     _linkedBinding(name: 'electron_browser_power_save_blocker'): { powerSaveBlocker: Electron.PowerSaveBlocker };
     _linkedBinding(name: 'electron_browser_session'): typeof Electron.Session;
+    _linkedBinding(name: 'electron_browser_shared_values'): {
+      setSharedValue(key: string, value: any, session?: Electron.Session): void;
+      deleteSharedValue(key: string): void;
+    };
     _linkedBinding(name: 'electron_browser_system_preferences'): { systemPreferences: Electron.SystemPreferences };
     _linkedBinding(name: 'electron_browser_tray'): { Tray: Electron.Tray };
     _linkedBinding(name: 'electron_browser_view'): { View: Electron.View };
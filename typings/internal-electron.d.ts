@@ -87,7 +87,8 @@ declare namespace Electron {
   interface WebFrameMain {
     _send(internal: boolean, channel: string, args: any): void;
     _sendInternal(channel: string, ...args: any[]): void;
-    _postMessage(channel: string, message: any, transfer?: any[]): void;
+    _postMessage(internal: boolean, channel: string, message: any, transfer?: any[]): void;
+    _postMessageInternal(channel: string, message: any, transfer?: any[]): void;
   }
 
   interface WebPreferences {